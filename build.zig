@@ -9,11 +9,106 @@ const Entry = struct {
     surprisal: f64,
 };
 
+// First line of the generated header. Bump the format number whenever the layout of clues.h
+// changes so that an existing header gets regenerated instead of failing to compile.
+const clues_header_marker = "// clues.h format 5, generated by build.zig\n";
+
+// The dictionary is cut into this many equal slices by surprisal, see `word_buckets` in clues.h.
+const bucket_count = 256;
+
+// Only words made up entirely of letters can go on the board.
+fn isAllLetters(word: []const u8) bool {
+    if (word.len == 0) return false;
+    for (word) |c| {
+        if (!std.ascii.isAlphabetic(c)) return false;
+    }
+    return true;
+}
+
+// Letter codes in `word_letters`: A-Z (either case) are 0-25 and anything else is other_letter.
+const other_letter = 26;
+
+fn letterCode(c: u8) u8 {
+    return if (std.ascii.isAlphabetic(c)) std.ascii.toUpper(c) - 'A' else other_letter;
+}
+
+// A deduplicated string pool. Text is stored NUL terminated, and words as letter codes without a
+// terminator, since every word has its length.
+const Pool = struct {
+    bytes: std.ArrayListUnmanaged(u8) = .{},
+    offsets: std.StringHashMapUnmanaged(u32) = .{},
+
+    fn deinit(self: *Pool, allocator: std.mem.Allocator) void {
+        self.bytes.deinit(allocator);
+        self.offsets.deinit(allocator);
+    }
+
+    // Offset of `text` in the pool, appending it the first time it's seen.
+    fn intern(self: *Pool, allocator: std.mem.Allocator, text: []const u8, as_letters: bool) u32 {
+        if (self.offsets.get(text)) |offset| return offset;
+        if (self.bytes.items.len > std.math.maxInt(u32)) @panic("string pool too large");
+
+        const offset: u32 = @intCast(self.bytes.items.len);
+        if (as_letters) {
+            for (text) |c| self.bytes.append(allocator, letterCode(c)) catch @panic("append failed");
+        } else {
+            self.bytes.appendSlice(allocator, text) catch @panic("append failed");
+            self.bytes.append(allocator, 0) catch @panic("append failed");
+        }
+        self.offsets.put(allocator, text, offset) catch @panic("put failed");
+        return offset;
+    }
+};
+
+// Word and clue lengths are unsigned chars in clues.h, and categories are numbered with them too.
+const max_text_length = std.math.maxInt(u8);
+const max_categories = std.math.maxInt(u8) + 1;
+
+// `text` cut to max_text_length bytes, without splitting a UTF-8 character.
+fn truncateText(text: []const u8) []const u8 {
+    if (text.len <= max_text_length) return text;
+
+    var end: usize = max_text_length;
+    while (end > 0 and (text[end] & 0xC0) == 0x80) end -= 1;
+    return text[0..end];
+}
+
+// Index of `name` in the interned categories, or 0 (no category) if it didn't fit in them.
+fn categoryId(categories: []const []const u8, name: []const u8) usize {
+    for (categories, 0..) |c, i| {
+        if (std.mem.eql(u8, c, name)) return i;
+    }
+    return 0;
+}
+
+fn cluesHeaderIsCurrent(path: []const u8) bool {
+    var file = std.fs.cwd().openFile(path, .{}) catch return false;
+    defer file.close();
+
+    var buf: [clues_header_marker.len]u8 = undefined;
+    const n = file.readAll(&buf) catch return false;
+    return n == buf.len and std.mem.eql(u8, &buf, clues_header_marker);
+}
+
+// Sources for the offline puzzle pack tool (tools/pack_puzzles.c). It doesn't need raylib.
+const pack_sources = [_][]const u8{
+    "tools/pack_puzzles.c",
+    "src/clues.c",
+    "src/crossword.c",
+    "src/dictionary.c",
+    "src/dynamic_array.c",
+    "src/fill.c",
+    "src/generator.c",
+    "src/mem.c",
+    "src/puzzle_pack.c",
+    "src/thread.c",
+};
+
 pub fn build(b: *std.Build) void {
     ///////////////////////////////////////////////////////////////////////////
     // create the clue dataset
     const header_path = "src" ++ std.fs.path.sep_str ++ "clues.h";
-    std.fs.cwd().access(header_path, .{}) catch {
+    if (!cluesHeaderIsCurrent(header_path)) {
         var gpa = std.heap.GeneralPurposeAllocator(.{}){};
         defer _ = gpa.deinit();
         const allocator = gpa.allocator();
@@ -23,6 +118,8 @@ pub fn build(b: *std.Build) void {
 
         var entries: std.ArrayListUnmanaged(Entry) = .{};
         defer entries.deinit(allocator);
+        var skipped_words: usize = 0;
+        var truncated_clues: usize = 0;
 
         var line_iter = std.mem.splitScalar(u8, word_file, '\n');
         while (line_iter.next()) |line| {
@@ -58,16 +155,32 @@ pub fn build(b: *std.Build) void {
 
             const surprisal = -@log(std.fmt.parseFloat(f64, fields[1]) catch @panic("unable to calculate surprisal"));
 
+            // a word that long could never go on the board anyway, but a long clue is only cut
+            if (fields[0].len > max_text_length) {
+                skipped_words += 1;
+                continue;
+            }
+            for (fields[3..6]) |clue| {
+                if (clue.len > max_text_length) truncated_clues += 1;
+            }
+
             entries.append(allocator, .{
                 .word = fields[0],
                 .category = fields[2],
-                .clue1 = fields[3],
-                .clue2 = fields[4],
-                .clue3 = fields[5],
+                .clue1 = truncateText(fields[3]),
+                .clue2 = truncateText(fields[4]),
+                .clue3 = truncateText(fields[5]),
                 .surprisal = surprisal,
             }) catch @panic("append failed");
         }
 
+        if (skipped_words > 0) {
+            std.debug.print("warning: {s}: skipped {d} words longer than {d} bytes\n", .{ word_path, skipped_words, max_text_length });
+        }
+        if (truncated_clues > 0) {
+            std.debug.print("warning: {s}: cut {d} clues to {d} bytes\n", .{ word_path, truncated_clues, max_text_length });
+        }
+
         // Sort by surprisal (lowest to highest)
         std.mem.sort(Entry, entries.items, {}, struct {
             fn lessThan(_: void, lhs: Entry, rhs: Entry) bool {
@@ -75,9 +188,37 @@ pub fn build(b: *std.Build) void {
             }
         }.lessThan);
 
+        var max_length: usize = 0;
+        for (entries.items) |e| max_length = @max(max_length, e.word.len);
+
+        // Intern the categories: 0 is the empty one, for words without a category, and the rest
+        // are sorted by name
+        var categories: std.ArrayListUnmanaged([]const u8) = .{};
+        defer categories.deinit(allocator);
+        categories.append(allocator, "") catch @panic("append failed");
+        for (entries.items) |e| categories.append(allocator, e.category) catch @panic("append failed");
+        std.mem.sort([]const u8, categories.items[1..], {}, struct {
+            fn lessThan(_: void, lhs: []const u8, rhs: []const u8) bool {
+                return std.mem.lessThan(u8, lhs, rhs);
+            }
+        }.lessThan);
+
+        var unique: usize = 1;
+        for (categories.items[1..]) |c| {
+            if (std.mem.eql(u8, c, categories.items[unique - 1])) continue;
+            categories.items[unique] = c;
+            unique += 1;
+        }
+        if (unique > max_categories) {
+            std.debug.print("warning: {s}: only the first {d} of {d} categories are kept, the words of the rest have none\n", .{ word_path, max_categories - 1, unique - 1 });
+            unique = max_categories;
+        }
+        categories.shrinkRetainingCapacity(unique);
+
         // Write header file
         var header_file = std.fs.cwd().createFile(header_path, .{}) catch @panic("failed to create header file");
 
+        header_file.writeAll(clues_header_marker) catch @panic("write failed");
         header_file.writeAll(
             \\#ifndef _CLUES_
             \\#define _CLUES_
@@ -85,29 +226,78 @@ pub fn build(b: *std.Build) void {
             \\#include <stddef.h>
             \\
             \\typedef struct {
-            \\    char *word;
-            \\    size_t word_length;
-            \\    char *category;
-            \\    char *clues[3];
-            \\    size_t clue_length[3];
-            \\    double surprisal;
+            \\    unsigned int word;     // offset into word_letters
+            \\    unsigned int clues[3]; // offsets into words_text
+            \\    float surprisal;
+            \\    unsigned char word_length;
+            \\    unsigned char clue_length[3];
+            \\    unsigned char category; // index into word_categories
             \\} Word;
             \\
-            \\static const Word words[] = {
+            \\extern const Word words[];
+            \\extern const size_t words_count;
+            \\
+            \\// Every clue once, NUL terminated, however many words share it.
+            \\extern const char words_text[];
+            \\
+            \\// Every word's letters as codes, A-Z (either case) as 0-25 and anything else as
+            \\// WORDS_OTHER_LETTER, so that nothing has to change case or check for letters.
+            \\#define WORDS_OTHER_LETTER 26
+            \\extern const unsigned char word_letters[];
+            \\
+            \\// Category names, interned. Words without a category have 0, the empty name.
             \\
         ) catch @panic("write failed");
 
+        var define_buf: [128]u8 = undefined;
+        const category_define = std.fmt.bufPrint(&define_buf, "#define WORDS_CATEGORIES {d}\n", .{categories.items.len}) catch @panic("format failed");
+        header_file.writeAll(category_define) catch @panic("write failed");
+
+        header_file.writeAll(
+            \\extern const char *const word_categories[WORDS_CATEGORIES];
+            \\
+            \\// Quantiles by surprisal: words[word_buckets[b], word_buckets[b + 1]) is the b'th of
+            \\// WORDS_BUCKETS equal slices of `words`, easiest first, and word_bucket_lengths[b][n] is
+            \\// how many of its words have n letters. Only words made up entirely of letters are
+            \\// counted, since nothing else can go on the board.
+            \\
+        ) catch @panic("write failed");
+
+        const defines = std.fmt.bufPrint(&define_buf, "#define WORDS_BUCKETS {d}\n#define WORDS_MAX_LENGTH {d}\n", .{ bucket_count, max_length }) catch @panic("format failed");
+        header_file.writeAll(defines) catch @panic("write failed");
+
+        header_file.writeAll(
+            \\
+            \\extern const unsigned int word_buckets[WORDS_BUCKETS + 1];
+            \\extern const unsigned short word_bucket_lengths[WORDS_BUCKETS][WORDS_MAX_LENGTH + 1];
+            \\
+            \\// defined once, in clues.c
+            \\#ifdef CLUES_IMPLEMENTATION
+            \\const Word words[] = {
+            \\
+        ) catch @panic("write failed");
+
+        var text: Pool = .{};
+        defer text.deinit(allocator);
+        var letters: Pool = .{};
+        defer letters.deinit(allocator);
+
         for (entries.items) |e| {
-            var buf: [2048]u8 = undefined;
+            var buf: [256]u8 = undefined;
             const formatted = std.fmt.bufPrint(&buf,
-                \\    {{"{s}", {d}, "{s}", {{"{s}", "{s}", "{s}"}}, {{{d}, {d}, {d}}}, {d:.6}}},
+                \\    {{{d}, {{{d}, {d}, {d}}}, {d:.6}f, {d}, {{{d}, {d}, {d}}}, {d}}},
                 \\
             , .{
-                e.word,      e.word.len,
-                e.category,  e.clue1,
-                e.clue2,     e.clue3,
-                e.clue1.len, e.clue2.len,
-                e.clue3.len, e.surprisal,
+                letters.intern(allocator, e.word, true),
+                text.intern(allocator, e.clue1, false),
+                text.intern(allocator, e.clue2, false),
+                text.intern(allocator, e.clue3, false),
+                e.surprisal,
+                e.word.len,
+                e.clue1.len,
+                e.clue2.len,
+                e.clue3.len,
+                categoryId(categories.items, e.category),
             }) catch @panic("format failed");
 
             header_file.writeAll(formatted) catch @panic("write failed");
@@ -116,7 +306,104 @@ pub fn build(b: *std.Build) void {
         header_file.writeAll(
             \\};
             \\
-            \\static const size_t words_count = sizeof(words) / sizeof(words[0]);
+            \\const size_t words_count = sizeof(words) / sizeof(words[0]);
+            \\
+            \\const char words_text[] = {
+            \\
+        ) catch @panic("write failed");
+
+        // one clue per line
+        var line: std.ArrayListUnmanaged(u8) = .{};
+        defer line.deinit(allocator);
+        for (text.bytes.items) |c| {
+            if (line.items.len == 0) line.appendSlice(allocator, "   ") catch @panic("append failed");
+
+            var buf: [8]u8 = undefined;
+            const formatted = std.fmt.bufPrint(&buf, " {d},", .{@as(i8, @bitCast(c))}) catch @panic("format failed");
+            line.appendSlice(allocator, formatted) catch @panic("append failed");
+            if (c == 0) {
+                line.append(allocator, '\n') catch @panic("append failed");
+                header_file.writeAll(line.items) catch @panic("write failed");
+                line.clearRetainingCapacity();
+            }
+        }
+
+        header_file.writeAll(
+            \\};
+            \\
+            \\const unsigned char word_letters[] = {
+            \\
+        ) catch @panic("write failed");
+
+        var start: usize = 0;
+        while (start < letters.bytes.items.len) : (start += 32) {
+            line.clearRetainingCapacity();
+            line.appendSlice(allocator, "   ") catch @panic("append failed");
+            for (letters.bytes.items[start..@min(start + 32, letters.bytes.items.len)]) |c| {
+                var buf: [8]u8 = undefined;
+                const formatted = std.fmt.bufPrint(&buf, " {d},", .{c}) catch @panic("format failed");
+                line.appendSlice(allocator, formatted) catch @panic("append failed");
+            }
+            line.append(allocator, '\n') catch @panic("append failed");
+            header_file.writeAll(line.items) catch @panic("write failed");
+        }
+
+        header_file.writeAll(
+            \\};
+            \\
+            \\const char *const word_categories[WORDS_CATEGORIES] = {
+            \\
+        ) catch @panic("write failed");
+
+        for (categories.items) |c| {
+            var buf: [512]u8 = undefined;
+            const formatted = std.fmt.bufPrint(&buf, "    \"{s}\",\n", .{c}) catch @panic("format failed");
+            header_file.writeAll(formatted) catch @panic("write failed");
+        }
+
+        header_file.writeAll(
+            \\};
+            \\
+            \\const unsigned int word_buckets[WORDS_BUCKETS + 1] = {
+            \\
+        ) catch @panic("write failed");
+
+        const n = entries.items.len;
+        for (0..bucket_count + 1) |bucket| {
+            var buf: [64]u8 = undefined;
+            const formatted = std.fmt.bufPrint(&buf, "    {d},\n", .{n * bucket / bucket_count}) catch @panic("format failed");
+            header_file.writeAll(formatted) catch @panic("write failed");
+        }
+
+        header_file.writeAll(
+            \\};
+            \\
+            \\const unsigned short word_bucket_lengths[WORDS_BUCKETS][WORDS_MAX_LENGTH + 1] = {
+            \\
+        ) catch @panic("write failed");
+
+        const counts = allocator.alloc(usize, max_length + 1) catch @panic("alloc failed");
+        defer allocator.free(counts);
+        for (0..bucket_count) |bucket| {
+            @memset(counts, 0);
+            for (entries.items[n * bucket / bucket_count .. n * (bucket + 1) / bucket_count]) |e| {
+                if (isAllLetters(e.word)) counts[e.word.len] += 1;
+            }
+
+            header_file.writeAll("    {") catch @panic("write failed");
+            for (counts, 0..) |count, length| {
+                if (count > std.math.maxInt(u16)) @panic("too many words of one length in a bucket");
+
+                var buf: [16]u8 = undefined;
+                const formatted = std.fmt.bufPrint(&buf, "{s}{d}", .{ if (length == 0) "" else ", ", count }) catch @panic("format failed");
+                header_file.writeAll(formatted) catch @panic("write failed");
+            }
+            header_file.writeAll("},\n") catch @panic("write failed");
+        }
+
+        header_file.writeAll(
+            \\};
+            \\#endif
             \\
             \\#endif
             \\
@@ -124,7 +411,7 @@ pub fn build(b: *std.Build) void {
 
         header_file.close();
         allocator.free(word_file);
-    };
+    }
 
     ///////////////////////////////////////////////////////////////////////////
     // Create the build
@@ -171,4 +458,27 @@ pub fn build(b: *std.Build) void {
     run_cmd.step.dependOn(b.getInstallStep());
     if (b.args) |args| run_cmd.addArgs(args);
     b.step("run", "Run the game").dependOn(&run_cmd.step);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Offline puzzle pack tool: `zig build pack -- -o puzzles.pack`
+    const pack_exe = b.addExecutable(.{
+        .name = "pack_puzzles",
+        .root_module = b.createModule(.{
+            .target = target,
+            .optimize = optimize,
+            .link_libc = true,
+        }),
+    });
+
+    pack_exe.root_module.addIncludePath(b.path("src"));
+    pack_exe.root_module.addCSourceFiles(.{
+        .files = &pack_sources,
+        .flags = &.{ "-std=c99", "-Wall", "-Wextra", "-pedantic" },
+    });
+
+    const install_pack = b.addInstallArtifact(pack_exe, .{});
+    const pack_cmd = b.addRunArtifact(pack_exe);
+    pack_cmd.step.dependOn(&install_pack.step);
+    if (b.args) |args| pack_cmd.addArgs(args);
+    b.step("pack", "Precompute a puzzle pack for the game").dependOn(&pack_cmd.step);
 }
@@ -0,0 +1,136 @@
+#include "board_cache.h"
+
+#include <string.h>
+
+#include "board_immediate.h"
+
+// see main.c
+#define C const
+
+static bool bc_tile_empty(C Crossword *cw, C int tx, C int ty)
+{
+    C u64 columns = bits_low(CW_TILE_DIM) << (tx * CW_TILE_DIM);
+    for (int y = ty * CW_TILE_DIM; y < MIN(CW_DIM, (ty + 1) * CW_TILE_DIM); ++y)
+    {
+        if (cw->lines[0].occupied[y] & columns)
+            return false;
+    }
+
+    return true;
+}
+
+static void bc_unload_tile(Board_Cache *bc, C int tx, C int ty)
+{
+    if (bc->tiles[ty][tx].id != 0)
+    {
+        UnloadRenderTexture(bc->tiles[ty][tx]);
+        bc->tiles[ty][tx] = (RenderTexture2D){0};
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void board_cache_init(Board_Cache *bc)
+{
+    memset(bc, 0, sizeof(Board_Cache));
+
+    // tiles are sized once the cell size is known, this only checks that they can exist at all
+    RenderTexture2D probe = LoadRenderTexture(1, 1);
+    bc->supported = probe.id != 0;
+    if (bc->supported)
+    {
+        UnloadRenderTexture(probe);
+    }
+}
+
+void board_cache_cleanup(Board_Cache *bc)
+{
+    for (int ty = 0; ty < CW_TILES; ++ty)
+    {
+        for (int tx = 0; tx < CW_TILES; ++tx)
+        {
+            bc_unload_tile(bc, tx, ty);
+        }
+    }
+}
+
+void board_cache_update(Board_Cache *bc, C Crossword *cw, C int cell_width, C int cell_height)
+{
+    if (!bc->supported)
+        return;
+
+    C bool everything =
+        !bc->built || cell_width != bc->cell_width || cell_height != bc->cell_height;
+    if (everything)
+    {
+        board_cache_cleanup(bc);
+        bc->cell_width = cell_width;
+        bc->cell_height = cell_height;
+        bc->built = true;
+    }
+
+    for (int ty = 0; ty < CW_TILES; ++ty)
+    {
+        for (int tx = 0; tx < CW_TILES; ++tx)
+        {
+            if (!everything && bc->tile_versions[ty][tx] == cw->tile_versions[ty][tx])
+                continue;
+
+            bc->tile_versions[ty][tx] = cw->tile_versions[ty][tx];
+
+            // tiles only lose cells when the board is cleared
+            if (bc_tile_empty(cw, tx, ty))
+            {
+                bc_unload_tile(bc, tx, ty);
+                continue;
+            }
+
+            RenderTexture2D *tile = &bc->tiles[ty][tx];
+            if (tile->id == 0)
+            {
+                *tile = LoadRenderTexture(CW_TILE_DIM * cell_width, CW_TILE_DIM * cell_height);
+            }
+
+            BeginTextureMode(*tile);
+            ClearBackground(BLANK);
+            for (int y = ty * CW_TILE_DIM; y < MIN(CW_DIM, (ty + 1) * CW_TILE_DIM); ++y)
+            {
+                for (int x = tx * CW_TILE_DIM; x < MIN(CW_DIM, (tx + 1) * CW_TILE_DIM); ++x)
+                {
+                    C Cell *c = &cw->cells[y][x];
+                    if (c->correct_letter == 0)
+                        continue;
+
+                    board_immediate_cell(c, (x % CW_TILE_DIM) * cell_width,
+                                         (y % CW_TILE_DIM) * cell_height, cell_width, cell_height,
+                                         c->locked ? GRAY : WHITE, true);
+                }
+            }
+            EndTextureMode();
+        }
+    }
+}
+
+void board_cache_draw(C Board_Cache *bc, C Cell *selected)
+{
+    C int tile_width = CW_TILE_DIM * bc->cell_width;
+    C int tile_height = CW_TILE_DIM * bc->cell_height;
+
+    for (int ty = 0; ty < CW_TILES; ++ty)
+    {
+        for (int tx = 0; tx < CW_TILES; ++tx)
+        {
+            C Texture2D t = bc->tiles[ty][tx].texture;
+            if (t.id == 0)
+                continue;
+
+            // render textures are upside down
+            DrawTextureRec(t, (Rectangle){0, 0, (float)t.width, (float)-t.height},
+                           (Vector2){(float)(tx * tile_width), (float)(ty * tile_height)}, WHITE);
+        }
+    }
+
+    // the selection is drawn over the cached tile rather than being part of it
+    board_immediate_cell(selected, selected->x * bc->cell_width, selected->y * bc->cell_height,
+                         bc->cell_width, bc->cell_height, selected->locked ? LIGHTGRAY : YELLOW,
+                         true);
+}
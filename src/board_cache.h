@@ -0,0 +1,38 @@
+#ifndef _BOARD_CACHE_
+#define _BOARD_CACHE_
+
+#include "common.h"
+#include "crossword.h"
+#include "raylib.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// The board drawn from cached pixels. Every tile (see CW_TILE_DIM) with cells in it has a render
+// texture holding what its cells look like, which is only drawn again when the tile's version
+// changes. Drawing the board is then one textured quad per tile, plus the selected cell drawn on
+// top, so the selection moving around doesn't invalidate anything. Late in a game most of the
+// board is locked and its tiles are never drawn again.
+//
+// Needs render textures. `supported` is false without them (e.g., the software renderer), and
+// then Board_Mesh should be used.
+typedef struct
+{
+    bool supported;
+    bool built;
+    RenderTexture2D tiles[CW_TILES][CW_TILES]; // unloaded while a tile has no cells
+    u32 tile_versions[CW_TILES][CW_TILES];
+    int cell_width, cell_height;
+} Board_Cache;
+
+// Needs a window (and its GL context).
+extern void board_cache_init(Board_Cache *bc);
+extern void board_cache_cleanup(Board_Cache *bc);
+
+// Draws every tile that changed since the last update again, and all of them when the cell size
+// changed. Call outside of any texture or drawing mode.
+extern void board_cache_update(Board_Cache *bc, const Crossword *cw, const int cell_width,
+                               const int cell_height);
+
+// Call inside BeginMode2D.
+extern void board_cache_draw(const Board_Cache *bc, const Cell *selected);
+
+#endif
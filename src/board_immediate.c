@@ -0,0 +1,37 @@
+#include "board_immediate.h"
+
+// see main.c
+#define C const
+
+void board_immediate_cell(C Cell *c, C int x, C int y, C int cell_width, C int cell_height,
+                          C Color color, C bool letters)
+{
+    DrawRectangle(x, y, cell_width - 1, cell_height - 1, color);
+
+    if (letters && c->user_letter != 0)
+    {
+        C char text[2] = {c->user_letter, '\0'};
+        C int font_size = 40;
+        DrawText(text, x + 13, y + 5, font_size, BLACK);
+    }
+}
+
+void board_immediate_draw(C Crossword *cw, C Cell *selected, C int cell_width, C int cell_height,
+                          C bool letters)
+{
+    for (int y = 0; y < CW_DIM; ++y)
+    {
+        for (int x = 0; x < CW_DIM; ++x)
+        {
+            C Cell *c = &cw->cells[y][x];
+
+            if (c->correct_letter != 0)
+            {
+                C Color color = c == selected ? (c->locked ? LIGHTGRAY : YELLOW)
+                                              : (c->locked ? GRAY : WHITE);
+                board_immediate_cell(c, cell_width * x, cell_height * y, cell_width, cell_height,
+                                     color, letters);
+            }
+        }
+    }
+}
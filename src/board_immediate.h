@@ -0,0 +1,20 @@
+#ifndef _BOARD_IMMEDIATE_
+#define _BOARD_IMMEDIATE_
+
+#include "common.h"
+#include "crossword.h"
+#include "raylib.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// The board drawn the simple way: a rectangle and a letter per cell through raylib's batch every
+// frame. It keeps no state and works everywhere, so it's what everything else falls back to.
+
+// One cell with its top left corner at (x, y).
+extern void board_immediate_cell(const Cell *c, const int x, const int y, const int cell_width,
+                                 const int cell_height, const Color color, const bool letters);
+
+// Call inside BeginMode2D. Without `letters` only the cells are drawn.
+extern void board_immediate_draw(const Crossword *cw, const Cell *selected, const int cell_width,
+                                 const int cell_height, const bool letters);
+
+#endif
@@ -0,0 +1,236 @@
+#include "board_mesh.h"
+
+#include <string.h>
+
+#include "raymath.h"
+#include "rlgl.h"
+
+// see main.c
+#define C const
+
+#define BM_TILE_CELLS (CW_TILE_DIM * CW_TILE_DIM)
+#define BM_CELL_VERTICES 8 // background quad, then letter quad
+#define BM_TILE_VERTICES (BM_TILE_CELLS * BM_CELL_VERTICES)
+#define BM_VERTICES (CW_TILES * CW_TILES * BM_TILE_VERTICES)
+#define BM_QUADS (BM_VERTICES / 4)
+
+// letters are drawn the way DrawText(text, x + 13, y + 5, 40, BLACK) would draw them
+#define BM_FONT_SIZE 40
+#define BM_LETTER_X 13
+#define BM_LETTER_Y 5
+
+// mesh indices are unsigned shorts
+typedef char _bm_index_check[BM_VERTICES <= 0xFFFF ? 1 : -1];
+
+// first vertex of the cell's slot
+static size_t bm_cell_vertex(C i16 x, C i16 y)
+{
+    C size_t tile = (size_t)(y / CW_TILE_DIM) * CW_TILES + (size_t)(x / CW_TILE_DIM);
+    C size_t cell = (size_t)(y % CW_TILE_DIM) * CW_TILE_DIM + (size_t)(x % CW_TILE_DIM);
+    return (tile * BM_TILE_CELLS + cell) * BM_CELL_VERTICES;
+}
+
+// corners go top left, bottom left, bottom right, top right like rlgl's own quads, so the
+// triangles face the camera
+static void bm_quad(Board_Mesh *bm, C size_t v, C Rectangle dst, C Rectangle uv, C Color color)
+{
+    C float xs[4] = {dst.x, dst.x, dst.x + dst.width, dst.x + dst.width};
+    C float ys[4] = {dst.y, dst.y + dst.height, dst.y + dst.height, dst.y};
+    C float us[4] = {uv.x, uv.x, uv.x + uv.width, uv.x + uv.width};
+    C float vs[4] = {uv.y, uv.y + uv.height, uv.y + uv.height, uv.y};
+
+    float *position = bm->mesh.vertices + v * 3;
+    float *texcoord = bm->mesh.texcoords + v * 2;
+    unsigned char *rgba = bm->mesh.colors + v * 4;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        position[i * 3 + 0] = xs[i];
+        position[i * 3 + 1] = ys[i];
+        position[i * 3 + 2] = 0;
+        texcoord[i * 2 + 0] = us[i];
+        texcoord[i * 2 + 1] = vs[i];
+        rgba[i * 4 + 0] = color.r;
+        rgba[i * 4 + 1] = color.g;
+        rgba[i * 4 + 2] = color.b;
+        rgba[i * 4 + 3] = color.a;
+    }
+}
+
+static void bm_build_cell(Board_Mesh *bm, C Crossword *cw, C i16 x, C i16 y)
+{
+    C size_t v = bm_cell_vertex(x, y);
+    C Rectangle none = {0};
+
+    C Cell *c = x < CW_DIM && y < CW_DIM ? &cw->cells[y][x] : NULL;
+    if (!c || c->correct_letter == 0)
+    {
+        bm_quad(bm, v, none, none, BLANK);
+        bm_quad(bm, v + 4, none, none, BLANK);
+        return;
+    }
+
+    C Font font = GetFontDefault();
+    C float tex_w = (float)font.texture.width;
+    C float tex_h = (float)font.texture.height;
+
+    // the middle of the solid white rectangle shapes are drawn with, so sampling never bleeds
+    C Rectangle white = GetShapesTextureRectangle();
+    C Rectangle white_uv = {(white.x + white.width / 2) / tex_w,
+                            (white.y + white.height / 2) / tex_h, 0, 0};
+
+    C Color color = c == bm->selected ? (c->locked ? LIGHTGRAY : YELLOW)
+                                      : (c->locked ? GRAY : WHITE);
+    C Rectangle cell = {(float)(bm->cell_width * x), (float)(bm->cell_height * y),
+                        (float)(bm->cell_width - 1), (float)(bm->cell_height - 1)};
+    bm_quad(bm, v, cell, white_uv, color);
+
+    if (c->user_letter == 0 || c->user_letter == ' ')
+    {
+        bm_quad(bm, v + 4, none, none, BLANK);
+        return;
+    }
+
+    // same rectangles as DrawTextCodepoint
+    C GlyphInfo glyph = GetGlyphInfo(font, c->user_letter);
+    C Rectangle rec = GetGlyphAtlasRec(font, c->user_letter);
+    C float scale = (float)BM_FONT_SIZE / (float)font.baseSize;
+    C float pad = (float)font.glyphPadding;
+
+    C Rectangle dst = {cell.x + BM_LETTER_X + ((float)glyph.offsetX - pad) * scale,
+                       cell.y + BM_LETTER_Y + ((float)glyph.offsetY - pad) * scale,
+                       (rec.width + 2 * pad) * scale, (rec.height + 2 * pad) * scale};
+    C Rectangle uv = {(rec.x - pad) / tex_w, (rec.y - pad) / tex_h, (rec.width + 2 * pad) / tex_w,
+                      (rec.height + 2 * pad) / tex_h};
+    bm_quad(bm, v + 4, dst, uv, BLACK);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void board_mesh_init(Board_Mesh *bm)
+{
+    memset(bm, 0, sizeof(Board_Mesh));
+
+    bm->supported = rlGetVersion() != RL_OPENGL_11_SOFTWARE;
+    if (!bm->supported)
+        return;
+
+    // the mesh is textured by the font atlas alone, so shapes have to come from the same texture
+    assert(GetShapesTexture().id == GetFontDefault().texture.id);
+
+    // UnloadMesh frees these with raylib's allocator
+    bm->mesh.vertexCount = BM_VERTICES;
+    bm->mesh.triangleCount = BM_QUADS * 2;
+    bm->mesh.vertices = (float *)MemAlloc(BM_VERTICES * 3 * sizeof(float));
+    bm->mesh.texcoords = (float *)MemAlloc(BM_VERTICES * 2 * sizeof(float));
+    bm->mesh.colors = (unsigned char *)MemAlloc(BM_VERTICES * 4);
+    bm->mesh.indices = (unsigned short *)MemAlloc(BM_QUADS * 6 * sizeof(unsigned short));
+
+    // every cell's background quad comes first and the letter quads second, so the letters can
+    // be left out by drawing only the first half
+    for (size_t q = 0; q < BM_QUADS; ++q)
+    {
+        C size_t cell = q / 2;
+        C size_t letter = q % 2;
+        C unsigned short v = (unsigned short)(q * 4);
+        unsigned short *i = bm->mesh.indices + (letter * BM_QUADS / 2 + cell) * 6;
+        i[0] = v;
+        i[1] = (unsigned short)(v + 1);
+        i[2] = (unsigned short)(v + 2);
+        i[3] = v;
+        i[4] = (unsigned short)(v + 2);
+        i[5] = (unsigned short)(v + 3);
+    }
+
+    UploadMesh(&bm->mesh, true);
+
+    bm->material = LoadMaterialDefault();
+    bm->material.maps[MATERIAL_MAP_DIFFUSE].texture = GetFontDefault().texture;
+}
+
+void board_mesh_cleanup(Board_Mesh *bm)
+{
+    if (!bm->supported)
+        return;
+
+    UnloadMesh(bm->mesh);
+
+    // not UnloadMaterial, which would unload the font's texture along with it
+    MemFree(bm->material.maps);
+}
+
+void board_mesh_update(Board_Mesh *bm, C Crossword *cw, C Cell *selected, C int cell_width,
+                       C int cell_height)
+{
+    if (!bm->supported)
+        return;
+
+    C bool everything =
+        !bm->built || cell_width != bm->cell_width || cell_height != bm->cell_height;
+
+    bool dirty[CW_TILES][CW_TILES];
+    for (size_t ty = 0; ty < CW_TILES; ++ty)
+    {
+        for (size_t tx = 0; tx < CW_TILES; ++tx)
+        {
+            dirty[ty][tx] = everything || bm->tile_versions[ty][tx] != cw->tile_versions[ty][tx];
+        }
+    }
+
+    if (selected != bm->selected)
+    {
+        if (bm->selected)
+        {
+            dirty[bm->selected->y / CW_TILE_DIM][bm->selected->x / CW_TILE_DIM] = true;
+        }
+
+        dirty[selected->y / CW_TILE_DIM][selected->x / CW_TILE_DIM] = true;
+    }
+
+    bm->built = true;
+    bm->selected = selected;
+    bm->cell_width = cell_width;
+    bm->cell_height = cell_height;
+
+    for (i16 ty = 0; ty < CW_TILES; ++ty)
+    {
+        for (i16 tx = 0; tx < CW_TILES; ++tx)
+        {
+            if (!dirty[ty][tx])
+                continue;
+
+            for (i16 y = ty * CW_TILE_DIM; y < (ty + 1) * CW_TILE_DIM; ++y)
+            {
+                for (i16 x = tx * CW_TILE_DIM; x < (tx + 1) * CW_TILE_DIM; ++x)
+                {
+                    bm_build_cell(bm, cw, x, y);
+                }
+            }
+
+            bm->tile_versions[ty][tx] = cw->tile_versions[ty][tx];
+
+            // without buffers (OpenGL 1.1, software) these do nothing and the mesh is drawn
+            // straight from the arrays
+            C size_t first = bm_cell_vertex(tx * CW_TILE_DIM, ty * CW_TILE_DIM);
+            UpdateMeshBuffer(bm->mesh, RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION,
+                             bm->mesh.vertices + first * 3, BM_TILE_VERTICES * 3 * sizeof(float),
+                             (int)(first * 3 * sizeof(float)));
+            UpdateMeshBuffer(bm->mesh, RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD,
+                             bm->mesh.texcoords + first * 2, BM_TILE_VERTICES * 2 * sizeof(float),
+                             (int)(first * 2 * sizeof(float)));
+            UpdateMeshBuffer(bm->mesh, RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR,
+                             bm->mesh.colors + first * 4, BM_TILE_VERTICES * 4, (int)(first * 4));
+        }
+    }
+}
+
+void board_mesh_draw(C Board_Mesh *bm, C bool letters)
+{
+    Mesh mesh = bm->mesh;
+    if (!letters)
+    {
+        mesh.triangleCount /= 2;
+    }
+
+    // DrawMesh doesn't go through the batch, so anything already batched has to go first
+    rlDrawRenderBatchActive();
+    DrawMesh(mesh, bm->material, MatrixIdentity());
+}
@@ -0,0 +1,44 @@
+#ifndef _BOARD_MESH_
+#define _BOARD_MESH_
+
+#include "common.h"
+#include "crossword.h"
+#include "raylib.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// The board as one persistent mesh, so drawing it is a single draw call no matter how big the
+// board gets, instead of a rectangle and a letter per cell going through the immediate batch.
+//
+// Every cell on the board has a slot in the mesh up front: a background quad and a letter quad,
+// textured from the default font's atlas (backgrounds use its solid white shapes rectangle). Empty
+// cells are zero area quads. Slots are laid out tile by tile (see CW_TILE_DIM), so when a tile's
+// version changes its vertices are one contiguous range and are patched with a single sub-buffer
+// update per attribute. Nothing is rebuilt when cells are added since they already have a slot.
+//
+// `supported` is false on the software renderer, whose matrix stack doesn't come back from the
+// push and pop DrawMesh does around the mesh; draw with board_immediate.h there instead.
+typedef struct
+{
+    bool supported;
+    Mesh mesh;
+    Material material;
+    bool built;
+
+    u32 tile_versions[CW_TILES][CW_TILES];
+    const Cell *selected;
+    int cell_width, cell_height;
+} Board_Mesh;
+
+// Needs a window (and its GL context).
+extern void board_mesh_init(Board_Mesh *bm);
+extern void board_mesh_cleanup(Board_Mesh *bm);
+
+// Patches every tile that changed since the last update, plus the tiles the selection moved
+// between. A change of cell size patches everything.
+extern void board_mesh_update(Board_Mesh *bm, const Crossword *cw, const Cell *selected,
+                              const int cell_width, const int cell_height);
+
+// Call inside BeginMode2D. Without `letters` only the cells are drawn.
+extern void board_mesh_draw(const Board_Mesh *bm, const bool letters);
+
+#endif
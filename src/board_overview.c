@@ -0,0 +1,88 @@
+#include "board_overview.h"
+
+#include <string.h>
+
+#include "rlgl.h"
+
+// see main.c
+#define C const
+
+static void bo_load(Board_Overview *bo)
+{
+    C Image image = {bo->pixels, CW_DIM, CW_DIM, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+    bo->cells = LoadTextureFromImage(image);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void board_overview_init(Board_Overview *bo)
+{
+    memset(bo, 0, sizeof(Board_Overview));
+    bo->update_in_place = rlGetVersion() != RL_OPENGL_11_SOFTWARE;
+    bo_load(bo);
+}
+
+void board_overview_cleanup(Board_Overview *bo)
+{
+    if (bo->cells.id != 0)
+    {
+        UnloadTexture(bo->cells);
+    }
+}
+
+void board_overview_update(Board_Overview *bo, C Crossword *cw)
+{
+    bool changed = false;
+    for (int ty = 0; ty < CW_TILES; ++ty)
+    {
+        for (int tx = 0; tx < CW_TILES; ++tx)
+        {
+            if (bo->built && bo->tile_versions[ty][tx] == cw->tile_versions[ty][tx])
+                continue;
+
+            C int x0 = tx * CW_TILE_DIM;
+            C int y0 = ty * CW_TILE_DIM;
+            C int w = MIN(CW_TILE_DIM, CW_DIM - x0);
+            C int h = MIN(CW_TILE_DIM, CW_DIM - y0);
+
+            Color tile[CW_TILE_DIM * CW_TILE_DIM];
+            for (int y = 0; y < h; ++y)
+            {
+                for (int x = 0; x < w; ++x)
+                {
+                    C Cell *c = &cw->cells[y0 + y][x0 + x];
+                    tile[y * w + x] = c->correct_letter == 0 ? BLANK
+                                      : c->locked            ? GRAY
+                                                             : WHITE;
+                    bo->pixels[(y0 + y) * CW_DIM + x0 + x] = tile[y * w + x];
+                }
+            }
+
+            if (bo->update_in_place)
+            {
+                UpdateTextureRec(bo->cells, (Rectangle){(float)x0, (float)y0, (float)w, (float)h},
+                                 tile);
+            }
+
+            bo->tile_versions[ty][tx] = cw->tile_versions[ty][tx];
+            changed = true;
+        }
+    }
+
+    bo->built = true;
+    if (changed && !bo->update_in_place)
+    {
+        board_overview_cleanup(bo);
+        bo_load(bo);
+    }
+}
+
+void board_overview_draw(C Board_Overview *bo, C Cell *selected, C int cell_width,
+                         C int cell_height)
+{
+    DrawTexturePro(bo->cells, (Rectangle){0, 0, CW_DIM, CW_DIM},
+                   (Rectangle){0, 0, (float)(CW_DIM * cell_width), (float)(CW_DIM * cell_height)},
+                   (Vector2){0, 0}, 0, WHITE);
+
+    DrawRectangle(selected->x * cell_width, selected->y * cell_height, cell_width, cell_height,
+                  selected->locked ? LIGHTGRAY : YELLOW);
+}
@@ -0,0 +1,36 @@
+#ifndef _BOARD_OVERVIEW_
+#define _BOARD_OVERVIEW_
+
+#include "common.h"
+#include "crossword.h"
+#include "raylib.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// The board for when it's zoomed out too far to read: a CW_DIM x CW_DIM texture with one pixel
+// per cell in the cell's color, stretched over the board with point sampling. Drawing it is one
+// quad however big the board is. Only tiles whose version changed are recolored, and the selected
+// cell is drawn on top.
+//
+// The texture is created once and the changed tiles are patched into it. The software renderer
+// can't update a texture in place, so there it's loaded again from `pixels` instead, which is
+// cheap as its textures are only ever in memory.
+typedef struct
+{
+    Color pixels[CW_DIM * CW_DIM];
+    Texture2D cells;
+    bool update_in_place;
+    bool built;
+    u32 tile_versions[CW_TILES][CW_TILES];
+} Board_Overview;
+
+// Needs a window (and its GL context).
+extern void board_overview_init(Board_Overview *bo);
+extern void board_overview_cleanup(Board_Overview *bo);
+
+extern void board_overview_update(Board_Overview *bo, const Crossword *cw);
+
+// Call inside BeginMode2D.
+extern void board_overview_draw(const Board_Overview *bo, const Cell *selected,
+                                const int cell_width, const int cell_height);
+
+#endif
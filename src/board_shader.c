@@ -0,0 +1,223 @@
+#include "board_shader.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "rlgl.h"
+
+// see main.c
+#define C const
+
+// letters are drawn the way DrawText(text, x + 13, y + 5, 40, BLACK) would draw them
+#define BS_FONT_SIZE 40
+#define BS_LETTER_X 13
+#define BS_LETTER_Y 5
+#define BS_LETTERS 26
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Shader source. The body is shared, and the header papers over the differences between GLSL 330
+// (desktop) and GLSL 100 (ES 2.0, web). raylib's default vertex shader is used as is.
+static C char *bs_header_330 = "#version 330\n"
+                               "#define IN in\n"
+                               "#define TEXTURE texture\n"
+                               "#define FRAG_COLOR finalColor\n"
+                               "out vec4 finalColor;\n";
+
+// cells are found from the texture coordinate, which needs more than mediump to be pixel exact
+static C char *bs_header_100 = "#version 100\n"
+                               "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+                               "precision highp float;\n"
+                               "#else\n"
+                               "precision mediump float;\n"
+                               "#endif\n"
+                               "#define IN varying\n"
+                               "#define TEXTURE texture2D\n"
+                               "#define FRAG_COLOR gl_FragColor\n";
+
+// Texel channels: r is the letter (1-26, 0 for none), g is set for cells on the board and b for
+// locked cells. Each cell leaves its last column and row of pixels empty, like DrawRectangle with
+// a width and height one less than the cell's.
+static C char *bs_body =
+    "IN vec2 fragTexCoord;\n"
+    "IN vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform sampler2D glyphs;\n"
+    "uniform vec2 cellSize;\n"
+    "uniform vec2 selected;\n"
+    "uniform float letters;\n"
+    "uniform vec4 colorOpen;\n"
+    "uniform vec4 colorLocked;\n"
+    "uniform vec4 colorSelected;\n"
+    "uniform vec4 colorSelectedLocked;\n"
+    "void main()\n"
+    "{\n"
+    "    vec2 board = fragTexCoord*DIM;\n"
+    "    vec2 cell = floor(board);\n"
+    "    vec2 local = (board - cell)*cellSize;\n"
+    "    vec4 state = TEXTURE(texture0, (cell + 0.5)/DIM);\n"
+    "    if (state.g < 0.5 || local.x >= cellSize.x - 1.0 || local.y >= cellSize.y - 1.0)"
+    " discard;\n"
+    "    bool isSelected = cell.x == selected.x && cell.y == selected.y;\n"
+    "    vec4 color = state.b > 0.5 ? (isSelected ? colorSelectedLocked : colorLocked)\n"
+    "                               : (isSelected ? colorSelected : colorOpen);\n"
+    "    float letter = floor(state.r*255.0 + 0.5);\n"
+    "    if (letter > 0.0 && letters > 0.5)\n"
+    "    {\n"
+    "        vec2 uv = vec2((letter - 1.0 + local.x/cellSize.x)/LETTERS,\n"
+    "                       1.0 - local.y/cellSize.y);\n"
+    "        vec4 glyph = TEXTURE(glyphs, uv);\n"
+    "        color.rgb = mix(color.rgb, glyph.rgb, glyph.a);\n"
+    "    }\n"
+    "    FRAG_COLOR = color*fragColor;\n"
+    "}\n";
+
+static void bs_set_color(C Board_Shader *bs, C char *name, C Color color)
+{
+    C Vector4 value = ColorNormalize(color);
+    SetShaderValue(bs->shader, GetShaderLocation(bs->shader, name), &value,
+                   SHADER_UNIFORM_VEC4);
+}
+
+// Render textures are upside down, which the shader accounts for.
+static void bs_draw_glyphs(Board_Shader *bs, C int cell_width, C int cell_height)
+{
+    if (bs->glyphs.id != 0)
+    {
+        UnloadRenderTexture(bs->glyphs);
+    }
+
+    bs->glyphs = LoadRenderTexture(BS_LETTERS * cell_width, cell_height);
+
+    BeginTextureMode(bs->glyphs);
+    ClearBackground(BLANK);
+    for (int i = 0; i < BS_LETTERS; ++i)
+    {
+        C char text[2] = {(char)('A' + i), '\0'};
+        DrawText(text, i * cell_width + BS_LETTER_X, BS_LETTER_Y, BS_FONT_SIZE, BLACK);
+    }
+    EndTextureMode();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void board_shader_init(Board_Shader *bs)
+{
+    memset(bs, 0, sizeof(Board_Shader));
+
+    C int version = rlGetVersion();
+    C char *header = NULL;
+    if (version == RL_OPENGL_33 || version == RL_OPENGL_43)
+    {
+        header = bs_header_330;
+    }
+    else if (version == RL_OPENGL_ES_20 || version == RL_OPENGL_ES_30)
+    {
+        header = bs_header_100;
+    }
+
+    if (!header)
+        return;
+
+    char source[4096];
+    snprintf(source, sizeof(source), "%s#define DIM %d.0\n#define LETTERS %d.0\n%s", header, CW_DIM,
+             BS_LETTERS, bs_body);
+
+    // raylib logs why and hands back its default shader when this fails
+    bs->shader = LoadShaderFromMemory(NULL, source);
+    if (bs->shader.id == rlGetShaderIdDefault())
+        return;
+
+    bs->glyphs_loc = GetShaderLocation(bs->shader, "glyphs");
+    bs->cell_size_loc = GetShaderLocation(bs->shader, "cellSize");
+    bs->selected_loc = GetShaderLocation(bs->shader, "selected");
+    bs->letters_loc = GetShaderLocation(bs->shader, "letters");
+    bs_set_color(bs, "colorOpen", WHITE);
+    bs_set_color(bs, "colorLocked", GRAY);
+    bs_set_color(bs, "colorSelected", YELLOW);
+    bs_set_color(bs, "colorSelectedLocked", LIGHTGRAY);
+
+    Image blank = GenImageColor(CW_DIM, CW_DIM, BLANK);
+    bs->cells = LoadTextureFromImage(blank);
+    UnloadImage(blank);
+
+    bs->supported = true;
+}
+
+void board_shader_cleanup(Board_Shader *bs)
+{
+    if (!bs->supported)
+        return;
+
+    UnloadShader(bs->shader);
+    UnloadTexture(bs->cells);
+    if (bs->glyphs.id != 0)
+    {
+        UnloadRenderTexture(bs->glyphs);
+    }
+}
+
+void board_shader_update(Board_Shader *bs, C Crossword *cw, C int cell_width, C int cell_height)
+{
+    if (!bs->supported)
+        return;
+
+    if (!bs->built || cell_width != bs->cell_width || cell_height != bs->cell_height)
+    {
+        bs_draw_glyphs(bs, cell_width, cell_height);
+        bs->cell_width = cell_width;
+        bs->cell_height = cell_height;
+    }
+
+    for (int ty = 0; ty < CW_TILES; ++ty)
+    {
+        for (int tx = 0; tx < CW_TILES; ++tx)
+        {
+            if (bs->built && bs->tile_versions[ty][tx] == cw->tile_versions[ty][tx])
+                continue;
+
+            C int x0 = tx * CW_TILE_DIM;
+            C int y0 = ty * CW_TILE_DIM;
+            C int w = MIN(CW_TILE_DIM, CW_DIM - x0);
+            C int h = MIN(CW_TILE_DIM, CW_DIM - y0);
+
+            u8 texels[CW_TILE_DIM * CW_TILE_DIM * 4];
+            for (int y = 0; y < h; ++y)
+            {
+                for (int x = 0; x < w; ++x)
+                {
+                    C Cell *c = &cw->cells[y0 + y][x0 + x];
+                    u8 *texel = texels + (y * w + x) * 4;
+                    C bool letter = c->user_letter >= 'A' && c->user_letter <= 'Z';
+                    texel[0] = letter ? (u8)(c->user_letter - 'A' + 1) : 0;
+                    texel[1] = c->correct_letter != 0 ? 255 : 0;
+                    texel[2] = c->locked ? 255 : 0;
+                    texel[3] = 255;
+                }
+            }
+
+            UpdateTextureRec(bs->cells, (Rectangle){(float)x0, (float)y0, (float)w, (float)h},
+                             texels);
+            bs->tile_versions[ty][tx] = cw->tile_versions[ty][tx];
+        }
+    }
+
+    bs->built = true;
+}
+
+void board_shader_draw(C Board_Shader *bs, C Cell *selected, C bool letters)
+{
+    C float show_letters = letters ? 1.f : 0.f;
+    C float cell_size[2] = {(float)bs->cell_width, (float)bs->cell_height};
+    C float selected_cell[2] = {(float)selected->x, (float)selected->y};
+
+    BeginShaderMode(bs->shader);
+    SetShaderValueTexture(bs->shader, bs->glyphs_loc, bs->glyphs.texture);
+    SetShaderValue(bs->shader, bs->cell_size_loc, cell_size, SHADER_UNIFORM_VEC2);
+    SetShaderValue(bs->shader, bs->selected_loc, selected_cell, SHADER_UNIFORM_VEC2);
+    SetShaderValue(bs->shader, bs->letters_loc, &show_letters, SHADER_UNIFORM_FLOAT);
+
+    DrawTexturePro(bs->cells, (Rectangle){0, 0, CW_DIM, CW_DIM},
+                   (Rectangle){0, 0, (float)(CW_DIM * bs->cell_width),
+                               (float)(CW_DIM * bs->cell_height)},
+                   (Vector2){0, 0}, 0, WHITE);
+    EndShaderMode();
+}
@@ -0,0 +1,42 @@
+#ifndef _BOARD_SHADER_
+#define _BOARD_SHADER_
+
+#include "common.h"
+#include "crossword.h"
+#include "raylib.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// The board as a single quad and a fragment shader. The state of every cell (its letter, whether
+// it is on the board and whether it is locked) is one texel of a CW_DIM x CW_DIM texture, and the
+// letters come from an atlas of the 26 letters pre-drawn at the current cell size. Each fragment
+// works out which cell it is in, reads that cell's texel and colors itself, so drawing costs the
+// same however much of the board is filled in. Only tiles whose version changed are re-uploaded.
+//
+// Needs shaders (OpenGL 3.3 or ES 2.0 and up). `supported` is false otherwise (OpenGL 1.1, the
+// software renderer) or when the shader doesn't compile, and then Board_Mesh should be used.
+typedef struct
+{
+    bool supported;
+    Shader shader;
+    Texture2D cells;        // one texel per cell: letter, on the board, locked
+    RenderTexture2D glyphs; // the letters A-Z side by side, one cell each
+    int glyphs_loc, cell_size_loc, selected_loc, letters_loc;
+
+    bool built;
+    u32 tile_versions[CW_TILES][CW_TILES];
+    int cell_width, cell_height;
+} Board_Shader;
+
+// Needs a window (and its GL context).
+extern void board_shader_init(Board_Shader *bs);
+extern void board_shader_cleanup(Board_Shader *bs);
+
+// Uploads every tile that changed since the last update, and redraws the letters when the cell
+// size changed. Call outside of any texture or drawing mode.
+extern void board_shader_update(Board_Shader *bs, const Crossword *cw, const int cell_width,
+                                const int cell_height);
+
+// Call inside BeginMode2D. Without `letters` only the cells are drawn.
+extern void board_shader_draw(const Board_Shader *bs, const Cell *selected, const bool letters);
+
+#endif
@@ -0,0 +1,4 @@
+// clues.h is generated by build.zig and holds the whole dictionary, so it is only instantiated in
+// this translation unit. Everything else includes it for the declarations.
+#define CLUES_IMPLEMENTATION
+#include "clues.h"
@@ -27,6 +27,38 @@ typedef double f64;
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
 
+///////////////////////////////////////////////////////////////////////////////
+// Bits
+///////////////////////////////////////////////////////////////////////////////
+static inline u32 bits_count(u64 x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (u32)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (u32)((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// index of the lowest set bit, x must not be 0
+static inline u32 bits_lowest(const u64 x)
+{
+    assert(x != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return (u32)__builtin_ctzll(x);
+#else
+    return bits_count((x & (~x + 1)) - 1);
+#endif
+}
+
+// mask with the lowest n bits set
+static inline u64 bits_low(const u32 n)
+{
+    return n >= 64 ? ~0ULL : (1ULL << n) - 1;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // In Between
 ///////////////////////////////////////////////////////////////////////////////
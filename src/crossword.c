@@ -0,0 +1,319 @@
+#include "crossword.h"
+
+#include <string.h>
+
+// see main.c
+#define C const
+
+// slot in Cw_Lines::letters of a cell's correct letter, which is always upper case
+static inline u32 cw_letter_slot(C char c)
+{
+    return (u32)(c - 'A');
+}
+
+void cw_init(Crossword *cw)
+{
+    memset(cw, 0, sizeof(Crossword));
+    cw->entries = (Crossword_Entry *)da_init(sizeof(Crossword_Entry), 16);
+    cw_clear(cw);
+}
+
+void cw_cleanup(Crossword *cw)
+{
+    da_cleanup(cw->entries);
+    cw->entries = NULL;
+}
+
+void cw_clear(Crossword *cw)
+{
+    da_clear(cw->entries);
+    ++cw->entries_version;
+    cw->vertical_mode = false;
+    memset(cw->cells, 0, sizeof(cw->cells));
+    memset(cw->lines, 0, sizeof(cw->lines));
+
+    for (i16 y = 0; y < CW_DIM; ++y)
+    {
+        for (i16 x = 0; x < CW_DIM; ++x)
+        {
+            Cell *c = &cw->cells[y][x];
+            c->x = x;
+            c->y = y;
+            c->horizontal_entry = CW_NO_ENTRY;
+            c->vertical_entry = CW_NO_ENTRY;
+            cw_touch_cell(cw, x, y);
+        }
+    }
+}
+
+void cw_copy(Crossword *dst, C Crossword *src)
+{
+    Crossword_Entry *entries = dst->entries;
+    memcpy(dst, src, sizeof(Crossword));
+    dst->entries = entries;
+    da_copy((void **)&dst->entries, src->entries);
+}
+
+bool cw_validate_entry(Crossword *cw, Crossword_Entry *ce)
+{
+    if (ce->complete)
+        return false;
+
+    i16 x = ce->start_x;
+    i16 y = ce->start_y;
+    bool valid = true;
+
+    for (size_t i = 0; i < ce->word_length; ++i)
+    {
+        C Cell *c = &cw->cells[y][x];
+        if (c->user_letter != c->correct_letter)
+        {
+            valid = false;
+            break;
+        }
+
+        x += ce->dir_x;
+        y += ce->dir_y;
+    }
+
+    if (valid)
+    {
+        ce->complete = true;
+        ++cw->entries_version;
+        x = ce->start_x;
+        y = ce->start_y;
+
+        for (size_t i = 0; i < ce->word_length; ++i)
+        {
+            cw->cells[y][x].locked = true;
+            cw_touch_cell(cw, x, y);
+
+            x += ce->dir_x;
+            y += ce->dir_y;
+        }
+    }
+
+    return valid;
+}
+
+bool cw_word_is_placeable(C Word *w)
+{
+    if (w->word_length < 2 || w->word_length > CW_DIM)
+        return false;
+
+    C u8 *letters = cw_word_letters(w);
+    for (size_t i = 0; i < w->word_length; ++i)
+    {
+        if (letters[i] == WORDS_OTHER_LETTER)
+            return false;
+    }
+
+    return true;
+}
+
+bool cw_contains_word(C Crossword *cw, C u32 word_index)
+{
+    for (size_t i = 0; i < cw_num_entries(cw); ++i)
+    {
+        if (cw->entries[i].word_index == word_index)
+            return true;
+    }
+
+    return false;
+}
+
+bool cw_add_packed_entry(Crossword *cw, C u32 word_index, C u16 placement)
+{
+    i16 x, y;
+    bool vertical;
+    u8 clue;
+    cw_unpack_placement(placement, &x, &y, &vertical, &clue);
+
+    // on the board, and crossing only letters that agree, the same as anything the game places
+    if (cw_num_entries(cw) >= CW_MAX_ENTRIES || word_index >= words_count || clue > 2 ||
+        !cw_word_is_placeable(words + word_index) ||
+        !cw_can_place(cw, words + word_index, x, y, vertical))
+        return false;
+
+    cw_add_entry(cw, word_index, x, y, vertical, clue);
+    return true;
+}
+
+u32 cw_words_hash(void)
+{
+    // FNV-1a over every word's length and letters, the length first so "ab" + "c" != "a" + "bc"
+    u32 hash = 2166136261u;
+    for (size_t i = 0; i < words_count; ++i)
+    {
+        hash ^= words[i].word_length;
+        hash *= 16777619u;
+
+        C u8 *letters = cw_word_letters(words + i);
+        for (size_t j = 0; j < words[i].word_length; ++j)
+        {
+            hash ^= letters[j];
+            hash *= 16777619u;
+        }
+    }
+
+    return hash;
+}
+
+u64 cw_legal_starts(C Crossword *cw, C Word *w, C i16 line, C bool vertical)
+{
+    C Cw_Lines *l = cw->lines + vertical;
+    C u32 length = (u32)w->word_length;
+    if (length == 0 || length > CW_DIM || line < 0 || line >= CW_DIM)
+        return 0;
+
+    C u64 occupied = l->occupied[line];
+    C u64 beside = (line > 0 ? l->occupied[line - 1] : 0) |
+                   (line < CW_DIM - 1 ? l->occupied[line + 1] : 0);
+
+    // a new letter can't sit right beside a parallel word, and a crossing has to agree on the
+    // letter and can't already be used in this direction
+    C u64 open = ~occupied & ~beside;
+    C u64 crossable = ~l->used[line];
+
+    // in bounds, and the word can't run into another word at either end
+    u64 starts = bits_low(CW_DIM - length + 1) & ~(occupied << 1) & ~(occupied >> length);
+    C u8 *letters = cw_word_letters(w);
+    for (u32 i = 0; starts != 0 && i < length; ++i)
+    {
+        C u64 fits = open | (l->letters[letters[i]][line] & crossable);
+        starts &= fits >> i;
+    }
+
+    return starts;
+}
+
+bool cw_can_place(C Crossword *cw, C Word *w, C i16 x, C i16 y, C bool vertical)
+{
+    C i16 line = vertical ? x : y;
+    C i16 at = vertical ? y : x;
+    if (at < 0 || at >= CW_DIM)
+        return false;
+
+    return (cw_legal_starts(cw, w, line, vertical) >> at) & 1;
+}
+
+bool cw_place_word(Crossword *cw, C Word *w, C bool vertical)
+{
+    C size_t num_entries = cw_num_entries(cw);
+    if (num_entries >= CW_MAX_ENTRIES || !cw_word_is_placeable(w))
+        return true;
+
+    bool valid_placement_found = false;
+    i16 x = 0, y = 0;
+    if (num_entries == 0)
+    {
+        // if there are no entries, there is no point looking for an interesection, and instead
+        // we'll just place the word in the center of the puzzle
+        x = (i16)(vertical ? CW_DIM / 2 : (CW_DIM - (i16)w->word_length) / 2);
+        y = (i16)(vertical ? (CW_DIM - (i16)w->word_length) / 2 : CW_DIM / 2);
+        valid_placement_found = true;
+    }
+    else
+    {
+        C Cw_Lines *l = cw->lines + vertical;
+        C u32 length = (u32)w->word_length;
+        C i16 offset = (i16)rng_range(&cw->rng, 0, CW_DIM - 1);
+
+        for (i16 _line = 0; !valid_placement_found && _line < CW_DIM; ++_line)
+        {
+            C i16 line = (i16)((_line + offset) % CW_DIM);
+            if (l->occupied[line] == 0)
+                continue;
+
+            // the new word has to cross at least one existing letter
+            u64 crossing = 0;
+            for (u32 i = 0; i < length; ++i)
+            {
+                crossing |= l->occupied[line] >> i;
+            }
+
+            u64 starts = cw_legal_starts(cw, w, line, vertical) & crossing;
+            if (starts == 0)
+                continue;
+
+            for (i32 skip = rng_range(&cw->rng, 0, (i32)bits_count(starts) - 1); skip > 0; --skip)
+            {
+                starts &= starts - 1;
+            }
+
+            C i16 at = (i16)bits_lowest(starts);
+            x = vertical ? line : at;
+            y = vertical ? at : line;
+            valid_placement_found = true;
+        }
+    }
+
+    if (!valid_placement_found)
+        return true; // unable to place word
+
+    cw_add_entry(cw, (u32)(w - words), x, y, vertical, (u8)rng_range(&cw->rng, 0, 2));
+    return false;
+}
+
+Crossword_Entry *cw_add_entry(Crossword *cw, C u32 word_index, i16 x, i16 y, C bool vertical,
+                              C u8 clue_index)
+{
+    assert(cw_num_entries(cw) < CW_MAX_ENTRIES);
+    assert(word_index < words_count);
+    assert(clue_index < 3);
+
+    C Word *w = words + word_index;
+    C u16 index = (u16)cw_num_entries(cw);
+    ++cw->entries_version;
+
+    Crossword_Entry *e = (Crossword_Entry *)da_append((void **)&cw->entries);
+    e->word_index = word_index;
+    e->start_x = x;
+    e->start_y = y;
+    e->clue_index = clue_index;
+    e->clue_str = words_text + w->clues[clue_index];
+    e->complete = false;
+    e->word_length = w->word_length;
+
+    C i16 dir_x = !vertical;
+    C i16 dir_y = vertical;
+    e->dir_x = dir_x;
+    e->dir_y = dir_y;
+
+    C u8 *letters = cw_word_letters(w);
+    Cell *c;
+    for (size_t i = 0; i < w->word_length; ++i)
+    {
+        c = &cw->cells[y][x];
+        if (c->correct_letter == 0)
+        {
+            c->user_letter = ' ';
+            c->correct_letter = (char)('A' + letters[i]);
+            c->locked = false;
+
+            C u32 letter = cw_letter_slot(c->correct_letter);
+            cw->lines[0].occupied[y] |= 1ULL << x;
+            cw->lines[1].occupied[x] |= 1ULL << y;
+            cw->lines[0].letters[letter][y] |= 1ULL << x;
+            cw->lines[1].letters[letter][x] |= 1ULL << y;
+        }
+
+        if (vertical)
+        {
+            c->vertical_entry = index;
+            cw->lines[1].used[x] |= 1ULL << y;
+        }
+        else
+        {
+            c->horizontal_entry = index;
+            cw->lines[0].used[y] |= 1ULL << x;
+        }
+
+        cw_touch_cell(cw, x, y);
+
+        x += dir_x;
+        y += dir_y;
+    }
+
+    return e;
+}
@@ -0,0 +1,166 @@
+#ifndef _CROSSWORD_
+#define _CROSSWORD_
+
+#include <stddef.h>
+
+#include "clues.h"
+#include "common.h"
+#include "dynamic_array.h"
+#include "rng.h"
+
+#define CW_DIM 50
+
+// The board is split into square tiles for change tracking. Every change to a cell bumps the
+// version of its tile, so snapshots (and anything else caching the board) can tell which parts of
+// the board changed since they last looked.
+#define CW_TILE_DIM 8
+#define CW_TILES ((CW_DIM + CW_TILE_DIM - 1) / CW_TILE_DIM)
+
+// Cells refer to entries by their index in `entries`, and this marks "no entry"
+#define CW_NO_ENTRY 0xFFFF
+#define CW_MAX_ENTRIES (CW_NO_ENTRY - 1)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Structures for defining the crossword grid that expands as the player plays the game.
+typedef struct
+{
+    const char *clue_str;
+    bool complete;
+    size_t word_length;
+    u32 word_index;
+    u8 clue_index;
+    i16 start_x, start_y;
+    i16 dir_x, dir_y;
+} Crossword_Entry;
+
+// Cells don't hold pointers so the grid can be copied with a single memcpy (e.g., to hand the
+// board to a worker thread) and so that `entries` is free to grow.
+typedef struct
+{
+    i16 x, y;
+    char user_letter;
+    char correct_letter;
+    bool locked;
+    u16 horizontal_entry;
+    u16 vertical_entry;
+} Cell;
+
+// Occupancy bitboards kept in sync with `cells` by cw_add_entry and cw_clear, so placement checks
+// are shifts and ANDs instead of walking cells. Line i of lines[0] is row i (bit x is cell (x, i))
+// and line i of lines[1] is column i (bit y is cell (i, y)), so horizontal and vertical words go
+// through the same code.
+typedef struct
+{
+    u64 occupied[CW_DIM];
+    u64 used[CW_DIM];        // cells that already belong to an entry running along the line
+    u64 letters[26][CW_DIM]; // cells holding each letter
+} Cw_Lines;
+
+typedef struct
+{
+    Crossword_Entry *entries; // dynamic array, see dynamic_array.h
+    i16 min_x, max_x, min_y, max_y;
+    Cell cells[CW_DIM][CW_DIM];
+    bool vertical_mode;
+    Rng rng;
+    Cw_Lines lines[2]; // indexed by `vertical`
+
+    u32 tile_versions[CW_TILES][CW_TILES];
+    u32 entries_version;
+} Crossword;
+
+// A word's letters as codes, A-Z as 0-25 (see word_letters in clues.h).
+static inline const u8 *cw_word_letters(const Word *w)
+{
+    return word_letters + w->word;
+}
+
+static inline void cw_touch_cell(Crossword *cw, const i16 x, const i16 y)
+{
+    ++cw->tile_versions[y / CW_TILE_DIM][x / CW_TILE_DIM];
+}
+
+static inline void cw_set_user_letter(Crossword *cw, Cell *c, const char letter)
+{
+    c->user_letter = letter;
+    cw_touch_cell(cw, c->x, c->y);
+}
+
+static inline size_t cw_num_entries(const Crossword *cw)
+{
+    return da_length(cw->entries);
+}
+
+// The returned pointer is only good until the next entry is added.
+static inline Crossword_Entry *cw_entry(const Crossword *cw, const u16 index)
+{
+    return index == CW_NO_ENTRY ? NULL : cw->entries + index;
+}
+
+static inline Crossword_Entry *cw_cell_entry(const Crossword *cw, const Cell *c,
+                                             const bool vertical)
+{
+    return cw_entry(cw, vertical ? c->vertical_entry : c->horizontal_entry);
+}
+
+// Entry placements are stored as x:6 | y:6 | vertical:1 | clue:2 in packs and save files.
+#define CW_PLACEMENT_X_SHIFT 0
+#define CW_PLACEMENT_Y_SHIFT 6
+#define CW_PLACEMENT_VERTICAL_SHIFT 12
+#define CW_PLACEMENT_CLUE_SHIFT 13
+
+// placements (and the occupancy bitboards) only have room for 64 cells a side
+typedef char _cw_placement_dim_check[CW_DIM <= 64 ? 1 : -1];
+
+static inline u16 cw_pack_placement(const i16 x, const i16 y, const bool vertical, const u8 clue)
+{
+    return (u16)(((u16)x << CW_PLACEMENT_X_SHIFT) | ((u16)y << CW_PLACEMENT_Y_SHIFT) |
+                 ((u16)vertical << CW_PLACEMENT_VERTICAL_SHIFT) |
+                 ((u16)clue << CW_PLACEMENT_CLUE_SHIFT));
+}
+
+static inline void cw_unpack_placement(const u16 p, i16 *x, i16 *y, bool *vertical, u8 *clue)
+{
+    *x = (i16)((p >> CW_PLACEMENT_X_SHIFT) & 0x3F);
+    *y = (i16)((p >> CW_PLACEMENT_Y_SHIFT) & 0x3F);
+    *vertical = (p >> CW_PLACEMENT_VERTICAL_SHIFT) & 1;
+    *clue = (u8)((p >> CW_PLACEMENT_CLUE_SHIFT) & 3);
+}
+
+// cw_init allocates the entries, so every crossword needs a matching cw_cleanup
+extern void cw_init(Crossword *cw);
+extern void cw_cleanup(Crossword *cw);
+extern void cw_clear(Crossword *cw);
+
+// Makes dst (which must have been through cw_init) an exact copy of src.
+extern void cw_copy(Crossword *dst, const Crossword *src);
+
+// Returns true if the entry was just completed (and its cells locked).
+extern bool cw_validate_entry(Crossword *cw, Crossword_Entry *ce);
+
+// Returns true when the word could not be placed.
+extern bool cw_place_word(Crossword *cw, const Word *w, const bool vertical);
+
+// Writes the word into the grid at the given position without any legality checks. This is used
+// when the placement is already known (e.g., a precomputed puzzle from a pack). The returned
+// pointer is only good until the next entry is added.
+extern Crossword_Entry *cw_add_entry(Crossword *cw, const u32 word_index, const i16 x, const i16 y,
+                                     const bool vertical, const u8 clue_index);
+
+extern bool cw_can_place(const Crossword *cw, const Word *w, const i16 x, const i16 y,
+                         const bool vertical);
+
+// Every start position along row `line` (or column, when vertical) where the word can legally go,
+// as a bitmask: bit i set means the word fits starting at cell i of the line.
+extern u64 cw_legal_starts(const Crossword *cw, const Word *w, const i16 line, const bool vertical);
+extern bool cw_word_is_placeable(const Word *w);
+extern bool cw_contains_word(const Crossword *cw, const u32 word_index);
+
+// Adds the entry stored as a packed placement after checking that it fits on the board (see
+// cw_can_place). Used when reading packs and save files.
+extern bool cw_add_packed_entry(Crossword *cw, const u32 word_index, const u16 placement);
+
+// hash of the dictionary so that packs and saves are never used with a different clues.h
+extern u32 cw_words_hash(void);
+
+#endif
@@ -0,0 +1,243 @@
+#include "dictionary.h"
+
+#include <string.h>
+
+#include "dynamic_array.h"
+#include "mem.h"
+
+// see main.c
+#define C const
+
+static bool dict_indexed(C Word *w)
+{
+    if (w->word_length == 0 || w->word_length > DICT_MAX_LENGTH)
+        return false;
+
+    C u8 *letters = cw_word_letters(w);
+    for (size_t i = 0; i < w->word_length; ++i)
+    {
+        if (letters[i] == DICT_OTHER)
+            return false;
+    }
+
+    return true;
+}
+
+static inline u64 *dict_bitset(C Dict_Group *g, C size_t position, C u32 letter)
+{
+    return g->positions + (position * DICT_LETTERS + letter) * g->blocks;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void dict_init(Dictionary *d)
+{
+    memset(d, 0, sizeof(Dictionary));
+
+    for (size_t length = 1; length <= DICT_MAX_LENGTH; ++length)
+    {
+        Dict_Group *g = d->groups + length;
+        g->bucket_first = (u32 *)mem_alloc(MEM_DICTIONARY, (WORDS_BUCKETS + 1) * sizeof(u32));
+        for (size_t b = 0; b < WORDS_BUCKETS; ++b)
+        {
+            C u32 count = length <= WORDS_MAX_LENGTH ? word_bucket_lengths[b][length] : 0;
+            g->bucket_first[b + 1] = g->bucket_first[b] + count;
+        }
+
+        g->count = g->bucket_first[WORDS_BUCKETS];
+        g->blocks = (g->count + 63) / 64;
+        g->word_ids = (u32 *)mem_alloc(MEM_DICTIONARY, MAX(g->count, 1) * sizeof(u32));
+        g->positions = (u64 *)mem_alloc(MEM_DICTIONARY,
+                                        MAX(length * DICT_LETTERS * g->blocks, 1) * sizeof(u64));
+        g->categories = (u64 *)mem_alloc(MEM_DICTIONARY,
+                                         MAX(WORDS_CATEGORIES * g->blocks, 1) * sizeof(u64));
+        g->count = 0;
+    }
+
+    // `words` is already in surprisal order, so each group ends up in that order too
+    for (size_t i = 0; i < words_count; ++i)
+    {
+        C Word *w = words + i;
+        if (!dict_indexed(w))
+            continue;
+
+        Dict_Group *g = d->groups + w->word_length;
+        assert(g->count < g->bucket_first[WORDS_BUCKETS]); // clues.h counted the same words
+        C u32 id = g->count++;
+        g->word_ids[id] = (u32)i;
+
+        C u8 *letters = cw_word_letters(w);
+        for (size_t p = 0; p < w->word_length; ++p)
+        {
+            dict_bitset(g, p, letters[p])[id / 64] |= 1ULL << (id % 64);
+        }
+
+        g->categories[w->category * g->blocks + id / 64] |= 1ULL << (id % 64);
+    }
+}
+
+void dict_cleanup(Dictionary *d)
+{
+    for (size_t length = 1; length <= DICT_MAX_LENGTH; ++length)
+    {
+        mem_free(d->groups[length].word_ids);
+        mem_free(d->groups[length].bucket_first);
+        mem_free(d->groups[length].positions);
+        mem_free(d->groups[length].categories);
+    }
+
+    memset(d, 0, sizeof(Dictionary));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Queries
+typedef struct
+{
+    C Dict_Group *group;
+    C u64 *fixed[DICT_MAX_LENGTH + 1]; // and the category's
+    size_t fixed_count;
+
+    // group ids [first, last) are the ones inside the requested word range
+    u32 first, last;
+} Dict_Query;
+
+// The bucket words[index] is in. The buckets are equal slices, so dividing gets to it or next to
+// it, and only empty buckets (with fewer words than buckets) need more than a step.
+static size_t dict_bucket(C size_t index)
+{
+    size_t b = MIN(index * WORDS_BUCKETS / words_count, WORDS_BUCKETS - 1);
+    while (b > 0 && word_buckets[b] > index)
+    {
+        --b;
+    }
+    while (b + 1 < WORDS_BUCKETS && word_buckets[b + 1] <= index)
+    {
+        ++b;
+    }
+
+    return b;
+}
+
+// first group id whose word index is >= `index`
+static u32 dict_lower_bound(C Dict_Group *g, C size_t index)
+{
+    C size_t b = dict_bucket(index);
+    if (word_buckets[b] == index)
+        return g->bucket_first[b];
+
+    u32 lo = g->bucket_first[b];
+    u32 hi = g->bucket_first[b + 1];
+    while (lo < hi)
+    {
+        C u32 mid = lo + (hi - lo) / 2;
+        if (g->word_ids[mid] < index)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+static bool dict_query_init(Dict_Query *q, C Dictionary *d, C char *pattern, C size_t start,
+                            C size_t end, C u8 category)
+{
+    C size_t length = strlen(pattern);
+    if (length == 0 || length > DICT_MAX_LENGTH || start >= end)
+        return false;
+
+    q->group = d->groups + length;
+    q->fixed_count = 0;
+    for (size_t p = 0; p < length; ++p)
+    {
+        if (pattern[p] != DICT_WILDCARD)
+        {
+            q->fixed[q->fixed_count++] = dict_bitset(q->group, p, dict_letter(pattern[p]));
+        }
+    }
+
+    if (category != DICT_ANY_CATEGORY)
+    {
+        assert(category < WORDS_CATEGORIES);
+        q->fixed[q->fixed_count++] = q->group->categories + category * q->group->blocks;
+    }
+
+    q->first = start == 0 ? 0 : dict_lower_bound(q->group, start);
+    q->last = end >= words_count ? q->group->count : dict_lower_bound(q->group, end);
+    return q->first < q->last;
+}
+
+// bits of block `b` that match the query
+static inline u64 dict_query_block(C Dict_Query *q, C u32 b)
+{
+    u64 bits = ~0ULL;
+    if (b == q->first / 64)
+    {
+        bits &= ~0ULL << (q->first % 64);
+    }
+    if (b == (q->last - 1) / 64 && q->last % 64 != 0)
+    {
+        bits &= ~0ULL >> (64 - q->last % 64);
+    }
+
+    for (size_t i = 0; bits != 0 && i < q->fixed_count; ++i)
+    {
+        bits &= q->fixed[i][b];
+    }
+
+    return bits;
+}
+
+size_t dict_count(C Dictionary *d, C char *pattern, C size_t start, C size_t end, C u8 category)
+{
+    Dict_Query q;
+    if (!dict_query_init(&q, d, pattern, start, end, category))
+        return 0;
+
+    if (q.fixed_count == 0)
+        return q.last - q.first;
+
+    size_t count = 0;
+    C u32 last_block = (q.last - 1) / 64;
+    for (u32 b = q.first / 64; b <= last_block; ++b)
+    {
+        count += bits_count(dict_query_block(&q, b));
+    }
+
+    return count;
+}
+
+size_t dict_match(C Dictionary *d, C char *pattern, C size_t start, C size_t end, C u8 category,
+                  u32 **matches)
+{
+    Dict_Query q;
+    if (!dict_query_init(&q, d, pattern, start, end, category))
+        return 0;
+
+    size_t count = 0;
+    C u32 last_block = (q.last - 1) / 64;
+    for (u32 b = q.first / 64; b <= last_block; ++b)
+    {
+        u64 bits = dict_query_block(&q, b);
+        while (bits != 0)
+        {
+            C u32 id = b * 64 + bits_lowest(bits);
+            bits &= bits - 1;
+
+            *(u32 *)da_append((void **)matches) = q.group->word_ids[id];
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+u8 dict_category(C char *name)
+{
+    for (size_t i = 1; i < WORDS_CATEGORIES; ++i)
+    {
+        if (strcmp(word_categories[i], name) == 0)
+            return (u8)i;
+    }
+
+    return DICT_ANY_CATEGORY;
+}
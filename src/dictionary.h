@@ -0,0 +1,78 @@
+#ifndef _DICTIONARY_
+#define _DICTIONARY_
+
+#include <stddef.h>
+
+#include "clues.h"
+#include "common.h"
+#include "crossword.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Pattern queries over `words`, e.g. "?A??E" for every five letter word with an A second and an E
+// last. Patterns are case insensitive and '?' matches any letter.
+//
+// Words are grouped by length, keeping the dictionary's surprisal order within each group. For
+// every position and letter of a group there is a bitset with one bit per word, so a query is the
+// AND of the bitsets of its fixed letters followed by a popcount. Only words made up entirely of
+// letters are indexed, since nothing else can go on the board. Non-letters in a pattern map to an
+// extra "other" slot that is always empty, so they match nothing.
+//
+// The groups are sized from the length histograms of the surprisal buckets in clues.h, which also
+// give the id of each bucket's first word in a group. Turning a range of `words` into a range of a
+// group is then a lookup, and only a range that starts or ends inside a bucket searches that one
+// bucket.
+//
+// Every group also has a bitset per category, so a themed query (only sports, say) is one more
+// bitset in the same AND. Queries for any category don't touch them.
+#define DICT_MAX_LENGTH CW_DIM
+#define DICT_LETTERS 27
+#define DICT_OTHER (DICT_LETTERS - 1)
+#if DICT_OTHER != WORDS_OTHER_LETTER
+#error "the dictionary indexes the letter codes in clues.h as they are"
+#endif
+#define DICT_WILDCARD '?'
+#define DICT_ANY_CATEGORY 0 // the empty category in clues.h, which no query needs
+
+typedef struct
+{
+    u32 count;
+    u32 blocks;        // u64s per bitset
+    u32 *word_ids;     // indexes into `words`, in surprisal order
+    u32 *bucket_first; // [WORDS_BUCKETS + 1], the id of the first word in each bucket
+    u64 *positions;    // [length][DICT_LETTERS][blocks]
+    u64 *categories;   // [WORDS_CATEGORIES][blocks]
+} Dict_Group;
+
+typedef struct
+{
+    Dict_Group groups[DICT_MAX_LENGTH + 1]; // by word length, 0 is unused
+} Dictionary;
+
+extern void dict_init(Dictionary *d);
+extern void dict_cleanup(Dictionary *d);
+
+// Number of words in words[start, end) of `category` matching the pattern. Pass 0, words_count,
+// DICT_ANY_CATEGORY for everything.
+extern size_t dict_count(const Dictionary *d, const char *pattern, const size_t start,
+                         const size_t end, const u8 category);
+
+// Appends the index of every word in words[start, end) of `category` matching the pattern to
+// `matches` (a dynamic array of u32), easiest first. Returns the number of matches appended.
+extern size_t dict_match(const Dictionary *d, const char *pattern, const size_t start,
+                         const size_t end, const u8 category, u32 **matches);
+
+// The category called `name`, or DICT_ANY_CATEGORY if there isn't one.
+extern u8 dict_category(const char *name);
+
+// Letter slot (0-25 for A-Z, DICT_OTHER otherwise) of a character.
+static inline u32 dict_letter(const char c)
+{
+    if (c >= 'a' && c <= 'z')
+        return (u32)(c - 'a');
+    if (c >= 'A' && c <= 'Z')
+        return (u32)(c - 'A');
+
+    return DICT_OTHER;
+}
+
+#endif
@@ -1,37 +1,27 @@
 #include "dynamic_array.h"
 
+#include <assert.h>
 #include <stddef.h>
-#include <stdio.h>
-#include <stdlib.h>
 #include <string.h> // memmove
 
+#include "mem.h"
+
 void *da_init(const size_t item_size, const size_t capacity)
 {
-    void *ptr = 0;
-    __DA_Header *h =
-        (__DA_Header *)malloc(item_size * capacity + sizeof(__DA_Header));
-
-    if (h)
-    {
-        h->length = 0;
-        h->capacity = capacity;
-        h->item_size = item_size;
-        ptr = h + 1;
-    }
-    else
-    {
-        fprintf(stderr, "Unable to initialize dynamic array with malloc.\n");
-        exit(1);
-    }
+    __DA_Header *h = (__DA_Header *)mem_alloc(
+        MEM_ARRAY, item_size * capacity + sizeof(__DA_Header));
 
-    return ptr;
+    h->length = 0;
+    h->capacity = capacity;
+    h->item_size = item_size;
+    return h + 1;
 }
 
 void da_cleanup(void *da)
 {
     if (da)
     {
-        free(((__DA_Header *)(da)-1));
+        mem_free(((__DA_Header *)(da)-1));
     }
 }
 
@@ -46,13 +36,8 @@ void da_ensure_capacity(void **da, const size_t capacity_increase)
             new_capacity *= 2;
         }
 
-        h = (__DA_Header *)realloc(h, h->item_size * new_capacity +
-                                          sizeof(__DA_Header));
-        if (!h)
-        {
-            fprintf(stderr, "Unable to resize dynamic array with realloc.\n");
-            exit(1);
-        }
+        h = (__DA_Header *)mem_realloc(
+            MEM_ARRAY, h, h->item_size * new_capacity + sizeof(__DA_Header));
 
         h->capacity = new_capacity;
         *da = h + 1;
@@ -150,6 +135,28 @@ void da_reverse(void *da)
     }
 }
 
+void da_clear(void *da)
+{
+    if (da)
+    {
+        ((__DA_Header *)(da)-1)->length = 0;
+    }
+}
+
+void da_copy(void **dst, const void *src)
+{
+    const __DA_Header *src_h = (const __DA_Header *)src - 1;
+    __DA_Header *h = ((__DA_Header *)(*dst) - 1);
+    assert(h->item_size == src_h->item_size);
+
+    h->length = 0;
+    da_ensure_capacity(dst, src_h->length);
+
+    h = ((__DA_Header *)(*dst) - 1);
+    memcpy(*dst, src, src_h->length * src_h->item_size);
+    h->length = src_h->length;
+}
+
 size_t da_length(const void *da)
 {
     return da ? ((const __DA_Header *)da - 1)->length : 0;
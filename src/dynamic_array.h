@@ -26,6 +26,10 @@ extern void da_pop_start(void *da);
 extern void da_pop_end(void *da);
 
 extern void da_reverse(void *da);
+extern void da_clear(void *da);
+
+// Makes dst an exact copy of src (which must hold the same item type), growing dst if needed.
+extern void da_copy(void **dst, const void *src);
 
 extern size_t da_length(const void *da);
 extern void da_increment_length(void *da);
@@ -0,0 +1,448 @@
+#include "fill.h"
+
+#include <string.h>
+
+#include "crossword.h"
+#include "mem.h"
+#include "thread.h"
+
+// see main.c
+#define C const
+
+#define FILL_MAX_SLOTS 64
+#define FILL_NO_SLOT 0xFF
+#define FILL_TABLE_PROBES 4
+
+// nogoods bigger than this rarely come up again, so they aren't worth keeping
+#define FILL_NOGOOD_MAX_SIZE 4
+#define FILL_NOGOOD_BUCKETS 1024
+#define FILL_NOGOOD_BUCKET_SIZE 4
+
+struct Fill_Table
+{
+    u64 mask;
+    u64 *keys; // 0 marks an empty slot
+};
+
+typedef struct
+{
+    u8 slot;
+    u8 position;
+} Fill_Crossing;
+
+// which slot (and position in it) covers each cell, by direction
+typedef u8 Fill_Cell_Map[2][CW_DIM][CW_DIM];
+
+// (slot, word) assignments that can't all be part of the same fill
+typedef struct
+{
+    u8 count;
+    u8 slots[FILL_NOGOOD_MAX_SIZE];
+    u32 words[FILL_NOGOOD_MAX_SIZE];
+} Fill_Nogood;
+
+// Sets of slots are u64 masks, which is where FILL_MAX_SLOTS comes from
+typedef struct
+{
+    Fill *f;
+    u64 key_seed;
+    u64 key;
+    bool aborted;
+
+    u64 assigned;
+    u64 crossing_slots[FILL_MAX_SLOTS];
+    char patterns[FILL_MAX_SLOTS][DICT_MAX_LENGTH + 1];
+    Fill_Crossing crossings[FILL_MAX_SLOTS][DICT_MAX_LENGTH];
+    u32 *candidates[FILL_MAX_SLOTS]; // dynamic arrays, one per depth
+
+    // every nogood is stored in the bucket of each of its assignments, replacing the oldest
+    Fill_Nogood nogoods[FILL_NOGOOD_BUCKETS][FILL_NOGOOD_BUCKET_SIZE];
+    u8 nogood_next[FILL_NOGOOD_BUCKETS];
+} Fill_Search;
+
+static inline u64 fill_mix(u64 x)
+{
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Zobrist keys are hashed on demand instead of stored, since a table would be slots x words big
+static inline u64 fill_zobrist(C Fill_Search *s, C size_t slot, C u32 word)
+{
+    return fill_mix(s->key_seed ^ fill_mix(((u64)slot << 32) | word));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Transposition table of dead states
+Fill_Table *fill_table_create(C u32 log2_size)
+{
+    assert(log2_size > 0 && log2_size < 40);
+    Fill_Table *t = (Fill_Table *)mem_alloc(MEM_FILL, sizeof(Fill_Table));
+    t->mask = (1ull << log2_size) - 1;
+    t->keys = (u64 *)mem_alloc(MEM_FILL, sizeof(u64) << log2_size);
+    return t;
+}
+
+void fill_table_destroy(Fill_Table *t)
+{
+    mem_free(t->keys);
+    mem_free(t);
+}
+
+static bool fill_table_contains(C Fill_Table *t, u64 key)
+{
+    key |= key == 0;
+    for (u64 p = 0; p < FILL_TABLE_PROBES; ++p)
+    {
+        C u64 k = atomic_load_u64(t->keys + ((key + p) & t->mask));
+        if (k == key)
+            return true;
+        if (k == 0)
+            return false;
+    }
+
+    return false;
+}
+
+static void fill_table_insert(Fill_Table *t, u64 key)
+{
+    // two threads racing on the same slot just means one of the keys is lost, which only costs
+    // a repeated search later
+    key |= key == 0;
+    for (u64 p = 0; p < FILL_TABLE_PROBES; ++p)
+    {
+        u64 *slot = t->keys + ((key + p) & t->mask);
+        C u64 k = atomic_load_u64(slot);
+        if (k == 0 || k == key)
+        {
+            atomic_store_u64(slot, key);
+            return;
+        }
+    }
+
+    atomic_store_u64(t->keys + (key & t->mask), key);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Nogoods
+static inline size_t fill_nogood_bucket(C Fill_Search *s, C size_t slot, C u32 word)
+{
+    return (size_t)(fill_zobrist(s, slot, word) & (FILL_NOGOOD_BUCKETS - 1));
+}
+
+static bool fill_nogood_holds(C Fill_Search *s, C Fill_Nogood *n, C size_t slot, C u32 word)
+{
+    bool mentions = false;
+    for (u8 i = 0; i < n->count; ++i)
+    {
+        if (n->slots[i] == slot)
+        {
+            if (n->words[i] != word)
+                return false;
+            mentions = true;
+        }
+        else if (!(s->assigned & (1ull << n->slots[i])) || s->f->words[n->slots[i]] != n->words[i])
+        {
+            return false;
+        }
+    }
+
+    return mentions;
+}
+
+// If assigning `word` to `slot` completes a known nogood, returns true with the other slots of the
+// nogood in `conflict`.
+static bool fill_nogood_check(C Fill_Search *s, C size_t slot, C u32 word, u64 *conflict)
+{
+    C Fill_Nogood *bucket = s->nogoods[fill_nogood_bucket(s, slot, word)];
+    for (size_t i = 0; i < FILL_NOGOOD_BUCKET_SIZE; ++i)
+    {
+        C Fill_Nogood *n = bucket + i;
+        if (n->count == 0 || !fill_nogood_holds(s, n, slot, word))
+            continue;
+
+        for (u8 j = 0; j < n->count; ++j)
+        {
+            *conflict |= 1ull << n->slots[j];
+        }
+        *conflict &= ~(1ull << slot);
+        return true;
+    }
+
+    return false;
+}
+
+static void fill_nogood_learn(Fill_Search *s, C u64 conflict)
+{
+    if (conflict == 0 || bits_count(conflict) > FILL_NOGOOD_MAX_SIZE)
+        return;
+
+    Fill_Nogood n = {0};
+    for (u64 c = conflict; c != 0; c &= c - 1)
+    {
+        C u8 slot = (u8)bits_lowest(c);
+        n.slots[n.count] = slot;
+        n.words[n.count] = s->f->words[slot];
+        ++n.count;
+    }
+
+    for (u8 i = 0; i < n.count; ++i)
+    {
+        C size_t b = fill_nogood_bucket(s, n.slots[i], n.words[i]);
+        s->nogoods[b][s->nogood_next[b]] = n;
+        s->nogood_next[b] = (u8)((s->nogood_next[b] + 1) % FILL_NOGOOD_BUCKET_SIZE);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Search
+//
+// A failed search returns its conflict set: the assigned slots whose words, between them, leave no
+// way to finish the fill. A slot's own conflicts are the assigned slots crossing it (they fixed its
+// letters) and the slots that already took one of its candidate words. If a candidate fails for
+// reasons that don't involve the slot at all, trying its other candidates can't help, so the
+// search jumps straight back to the most recent slot that is involved.
+
+// the slot that already holds `word`, or FILL_NO_SLOT
+static size_t fill_word_owner(C Fill_Search *s, C u32 word)
+{
+    for (u64 a = s->assigned; a != 0; a &= a - 1)
+    {
+        C size_t i = bits_lowest(a);
+        if (s->f->words[i] == word)
+            return i;
+    }
+
+    return FILL_NO_SLOT;
+}
+
+// the open slot with the fewest candidates, or FILL_NO_SLOT if every slot is filled
+static size_t fill_pick_slot(C Fill_Search *s, size_t *count)
+{
+    size_t best = FILL_NO_SLOT;
+    *count = SIZE_MAX;
+    for (size_t i = 0; i < s->f->slot_count; ++i)
+    {
+        if (s->assigned & (1ull << i))
+            continue;
+
+        C size_t n = dict_count(s->f->dict, s->patterns[i], s->f->start, s->f->end,
+                                s->f->category);
+        if (n < *count)
+        {
+            best = i;
+            *count = n;
+            if (n == 0)
+                break;
+        }
+    }
+
+    return best;
+}
+
+static bool fill_search(Fill_Search *s, C size_t depth, u64 *conflict)
+{
+    Fill *f = s->f;
+    *conflict = s->assigned;
+
+    if (f->node_limit != 0 && f->nodes >= f->node_limit)
+    {
+        s->aborted = true;
+        return false;
+    }
+
+    ++f->nodes;
+    if (f->table && fill_table_contains(f->table, s->key))
+    {
+        // the table doesn't know why the state is dead, so blame everything
+        ++f->table_hits;
+        return false;
+    }
+
+    size_t count;
+    C size_t slot = fill_pick_slot(s, &count);
+    if (slot == FILL_NO_SLOT)
+        return true;
+
+    C u64 slot_bit = 1ull << slot;
+    u64 conflicts = 0;
+    bool jumped = false;
+
+    if (count > 0)
+    {
+        u32 *candidates = s->candidates[depth];
+        da_clear(candidates);
+        dict_match(f->dict, s->patterns[slot], f->start, f->end, f->category,
+                   &s->candidates[depth]);
+        candidates = s->candidates[depth];
+
+        C size_t n = da_length(candidates);
+        for (size_t i = n; i > 1; --i)
+        {
+            C size_t j = (size_t)rng_range(&f->rng, 0, (i32)i - 1);
+            C u32 tmp = candidates[i - 1];
+            candidates[i - 1] = candidates[j];
+            candidates[j] = tmp;
+        }
+
+        C Fill_Slot *fs = f->slots + slot;
+        for (size_t i = 0; i < n; ++i)
+        {
+            C u32 word = candidates[i];
+            C size_t owner = fill_word_owner(s, word);
+            if (owner != FILL_NO_SLOT)
+            {
+                conflicts |= 1ull << owner;
+                continue;
+            }
+
+            if (fill_nogood_check(s, slot, word, &conflicts))
+            {
+                ++f->nogood_hits;
+                continue;
+            }
+
+            // write the word's letters into the crossing slots that are still open
+            C u8 *letters = cw_word_letters(words + word);
+            u8 undo[DICT_MAX_LENGTH];
+            size_t undo_count = 0;
+            for (u8 p = 0; p < fs->length; ++p)
+            {
+                C Fill_Crossing *x = &s->crossings[slot][p];
+                if (x->slot != FILL_NO_SLOT && s->patterns[x->slot][x->position] == DICT_WILDCARD)
+                {
+                    s->patterns[x->slot][x->position] = (char)('A' + letters[p]);
+                    undo[undo_count++] = p;
+                }
+            }
+
+            s->assigned |= slot_bit;
+            f->words[slot] = word;
+            C u64 z = fill_zobrist(s, slot, word);
+            s->key ^= z;
+
+            u64 child_conflict;
+            if (fill_search(s, depth + 1, &child_conflict))
+                return true;
+
+            s->assigned &= ~slot_bit;
+            s->key ^= z;
+            for (size_t u = 0; u < undo_count; ++u)
+            {
+                C Fill_Crossing *x = &s->crossings[slot][undo[u]];
+                s->patterns[x->slot][x->position] = DICT_WILDCARD;
+            }
+
+            if (s->aborted)
+                break;
+
+            if (!(child_conflict & slot_bit))
+            {
+                ++f->backjumps;
+                conflicts = child_conflict;
+                jumped = true;
+                break;
+            }
+
+            conflicts |= child_conflict & ~slot_bit;
+        }
+    }
+
+    if (!jumped)
+    {
+        conflicts |= s->crossing_slots[slot] & s->assigned;
+    }
+
+    // an aborted search proved nothing
+    if (s->aborted)
+        return false;
+
+    *conflict = conflicts;
+    fill_nogood_learn(s, conflicts);
+    if (f->table)
+    {
+        fill_table_insert(f->table, s->key);
+    }
+
+    return false;
+}
+
+bool fill_solve(Fill *f)
+{
+    assert(f->slot_count > 0 && f->slot_count <= FILL_MAX_SLOTS);
+    f->nodes = 0;
+    f->table_hits = 0;
+    f->backjumps = 0;
+    f->nogood_hits = 0;
+
+    Fill_Search *s = (Fill_Search *)mem_alloc(MEM_FILL, sizeof(Fill_Search));
+    s->f = f;
+
+    // the keys only mean anything for this exact set of slots and words, so a shared table can't
+    // confuse two different fills
+    s->key_seed = fill_mix(((u64)f->start << 32) ^ f->end ^ f->slot_count);
+    s->key_seed = fill_mix(s->key_seed ^ f->category);
+
+    Fill_Cell_Map *slot_map = (Fill_Cell_Map *)mem_alloc(MEM_FILL, sizeof(Fill_Cell_Map));
+    Fill_Cell_Map *position_map = (Fill_Cell_Map *)mem_alloc(MEM_FILL, sizeof(Fill_Cell_Map));
+    u8(*slot_at)[CW_DIM][CW_DIM] = *slot_map;
+    u8(*position_at)[CW_DIM][CW_DIM] = *position_map;
+    memset(slot_map, FILL_NO_SLOT, sizeof(Fill_Cell_Map));
+
+    for (size_t i = 0; i < f->slot_count; ++i)
+    {
+        C Fill_Slot *fs = f->slots + i;
+        assert(fs->length >= 1 && fs->length <= DICT_MAX_LENGTH);
+        s->key_seed = fill_mix(s->key_seed ^ cw_pack_placement(fs->x, fs->y, fs->vertical, 0) ^
+                               ((u64)fs->length << 16));
+
+        memset(s->patterns[i], DICT_WILDCARD, fs->length);
+        s->patterns[i][fs->length] = '\0';
+        s->candidates[i] = (u32 *)da_init(sizeof(u32), 64);
+
+        for (u8 p = 0; p < fs->length; ++p)
+        {
+            C i16 x = fs->x + (fs->vertical ? 0 : p);
+            C i16 y = fs->y + (fs->vertical ? p : 0);
+            assert(x >= 0 && y >= 0 && x < CW_DIM && y < CW_DIM);
+            assert(slot_at[fs->vertical][y][x] == FILL_NO_SLOT);
+            slot_at[fs->vertical][y][x] = (u8)i;
+            position_at[fs->vertical][y][x] = p;
+        }
+    }
+
+    for (size_t i = 0; i < f->slot_count; ++i)
+    {
+        C Fill_Slot *fs = f->slots + i;
+        for (u8 p = 0; p < fs->length; ++p)
+        {
+            C i16 x = fs->x + (fs->vertical ? 0 : p);
+            C i16 y = fs->y + (fs->vertical ? p : 0);
+            s->crossings[i][p].slot = slot_at[!fs->vertical][y][x];
+            s->crossings[i][p].position = position_at[!fs->vertical][y][x];
+            if (s->crossings[i][p].slot != FILL_NO_SLOT)
+            {
+                s->crossing_slots[i] |= 1ull << s->crossings[i][p].slot;
+            }
+        }
+    }
+
+    mem_free(slot_map);
+    mem_free(position_map);
+
+    // the empty fill is keyed by the seed as well, or one search that failed outright would make
+    // every other fill sharing the table look dead from the start
+    s->key = s->key_seed;
+
+    u64 conflict;
+    C bool solved = fill_search(s, 0, &conflict);
+
+    for (size_t i = 0; i < f->slot_count; ++i)
+    {
+        da_cleanup(s->candidates[i]);
+    }
+
+    mem_free(s);
+    return solved;
+}
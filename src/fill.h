@@ -0,0 +1,61 @@
+#ifndef _FILL_
+#define _FILL_
+
+#include <stddef.h>
+
+#include "common.h"
+#include "dictionary.h"
+#include "rng.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Backtracking fill of a fixed set of slots with words from words[start, end), optionally only of
+// one category. Slots that share a cell must agree on its letter, and no word is used twice.
+//
+// The search always fills the open slot with the fewest matching words next (fail first), using
+// dict_count on the slot's current pattern. A partial fill is identified by the XOR of one Zobrist
+// key per (slot, word) assignment, so the same partial grid reached in a different order has the
+// same key. When a partial fill is proven to have no solution its key goes into a Fill_Table,
+// which is lock-free and can be shared by any number of threads. The keys are seeded from the
+// slots, the word range and the category, so fills of anything else never see each other's keys.
+//
+// Failures are traced back to the slots that caused them, so the search backjumps over slots that
+// had nothing to do with a dead end, and small sets of assignments that failed together are kept
+// as nogoods so they're pruned wherever they show up again.
+typedef struct
+{
+    i16 x, y;
+    bool vertical;
+    u8 length;
+} Fill_Slot;
+
+typedef struct Fill_Table Fill_Table;
+
+// The table holds 2^log2_size dead states.
+extern Fill_Table *fill_table_create(const u32 log2_size);
+extern void fill_table_destroy(Fill_Table *t);
+
+typedef struct
+{
+    // inputs
+    const Dictionary *dict;
+    size_t start, end;
+    u8 category; // DICT_ANY_CATEGORY for words of any
+    const Fill_Slot *slots;
+    size_t slot_count;
+    Fill_Table *table; // optional
+    u64 node_limit;    // 0 for no limit
+    Rng rng;           // shuffles the candidates so the same slots don't always get the same words
+
+    // outputs
+    u32 *words;        // slot_count word indexes, valid when fill_solve returns true
+    u64 nodes;
+    u64 table_hits;
+    u64 backjumps;
+    u64 nogood_hits;
+} Fill;
+
+// Returns false if the slots can't be filled or the node limit was hit. `f->words` is allocated
+// by the caller.
+extern bool fill_solve(Fill *f);
+
+#endif
@@ -0,0 +1,307 @@
+#include "generator.h"
+
+#include <string.h>
+
+// see main.c
+#define C const
+
+#define GEN_ATTEMPTS_PER_WORD 64
+#define GEN_MAX_LATTICE_SLOTS 16
+
+#define GEN_FRONTIER_POINTS 16
+#define GEN_ATTEMPTS_PER_POINT 8
+#define GEN_MIN_GROWTH_LENGTH 3
+#define GEN_MAX_GROWTH_LENGTH 9
+
+typedef struct
+{
+    f32 priority;
+    i16 x, y;
+    bool vertical; // direction of the new word
+} Gen_Frontier_Point;
+
+// the best points found so far, in gen_frontier_before order
+typedef struct
+{
+    Gen_Frontier_Point points[GEN_FRONTIER_POINTS];
+    size_t count;
+} Gen_Frontier;
+
+void gen_band_range(C size_t band, C size_t band_count, size_t *start, size_t *end)
+{
+    assert(band < band_count);
+    *start = (words_count * band) / band_count;
+    *end = (words_count * (band + 1)) / band_count;
+}
+
+static size_t gen_random_word(Crossword *cw, C size_t start, C size_t end)
+{
+    assert(start < end);
+    return start + (size_t)rng_range(&cw->rng, 0, (i32)(end - start - 1));
+}
+
+bool gen_extend(Crossword *cw, C size_t start, C size_t end)
+{
+    if (cw_num_entries(cw) >= CW_MAX_ENTRIES)
+        return false;
+
+    for (size_t attempt = 0; attempt < GEN_ATTEMPTS_PER_WORD; ++attempt)
+    {
+        C size_t word_index = gen_random_word(cw, start, end);
+        if (cw_contains_word(cw, (u32)word_index))
+            continue;
+
+        C bool vertical = rng_range(&cw->rng, 0, 1) == 1;
+        if (!cw_place_word(cw, words + word_index, vertical))
+            return true;
+    }
+
+    return false;
+}
+
+static void gen_grow(Crossword *cw, C size_t start, C size_t end, C size_t target_entries)
+{
+    size_t failures = 0;
+    while (cw_num_entries(cw) > 0 && cw_num_entries(cw) < target_entries &&
+           failures < target_entries)
+    {
+        if (!gen_extend(cw, start, end))
+        {
+            ++failures;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Growth around the player
+static f32 gen_frontier_priority(C Gen_Focus *focus, C i16 x, C i16 y)
+{
+    C f32 dx = (f32)(x - focus->x);
+    C f32 dy = (f32)(y - focus->y);
+    f32 priority = dx * dx + dy * dy;
+
+    if (x < focus->view_min_x || x > focus->view_max_x || y < focus->view_min_y ||
+        y > focus->view_max_y)
+    {
+        priority += (f32)(CW_DIM * CW_DIM);
+    }
+
+    return priority;
+}
+
+// Closest to the focus first, and between points as close as each other, across before down and
+// then in board order, so that which points are kept doesn't depend on the order they're found in.
+static bool gen_frontier_before(C Gen_Frontier_Point *a, C Gen_Frontier_Point *b)
+{
+    if (a->priority != b->priority)
+        return a->priority < b->priority;
+    if (a->vertical != b->vertical)
+        return !a->vertical;
+
+    C i16 a_line = a->vertical ? a->x : a->y;
+    C i16 b_line = b->vertical ? b->x : b->y;
+    if (a_line != b_line)
+        return a_line < b_line;
+
+    return (a->vertical ? a->y : a->x) < (b->vertical ? b->y : b->x);
+}
+
+static void gen_frontier_add(Gen_Frontier *f, C Gen_Frontier_Point *p)
+{
+    if (f->count == GEN_FRONTIER_POINTS && !gen_frontier_before(p, f->points + f->count - 1))
+        return;
+
+    size_t i = f->count < GEN_FRONTIER_POINTS ? f->count++ : GEN_FRONTIER_POINTS - 1;
+    for (; i > 0 && gen_frontier_before(p, f->points + i - 1); --i)
+    {
+        f->points[i] = f->points[i - 1];
+    }
+
+    f->points[i] = *p;
+}
+
+// The best GEN_FRONTIER_POINTS crossing points, closest to the focus first. The open crossing
+// points are already kept up to date in the occupancy bitboards (letters that a new word in a
+// direction could run through), and only their order depends on the focus. Lines are visited from
+// the focus outwards, and a line further away than the worst point kept can't have anything better,
+// so usually only the lines around the focus are looked at.
+static void gen_frontier(Gen_Frontier *f, C Crossword *cw, C Gen_Focus *focus)
+{
+    f->count = 0;
+    for (int vertical = 0; vertical < 2; ++vertical)
+    {
+        C Cw_Lines *l = cw->lines + vertical;
+        C i16 center = vertical ? focus->x : focus->y;
+
+        for (i16 distance = 0; distance < CW_DIM; ++distance)
+        {
+            if (f->count == GEN_FRONTIER_POINTS &&
+                (f32)(distance * distance) > f->points[GEN_FRONTIER_POINTS - 1].priority)
+                break;
+
+            for (int side = 0; side < (distance == 0 ? 1 : 2); ++side)
+            {
+                C i16 line = side == 0 ? center - distance : center + distance;
+                if (line < 0 || line >= CW_DIM)
+                    continue;
+
+                for (u64 open = l->occupied[line] & ~l->used[line]; open != 0; open &= open - 1)
+                {
+                    C i16 at = (i16)bits_lowest(open);
+                    Gen_Frontier_Point p;
+                    p.x = vertical ? line : at;
+                    p.y = vertical ? at : line;
+                    p.vertical = vertical == 1;
+                    p.priority = gen_frontier_priority(focus, p.x, p.y);
+                    gen_frontier_add(f, &p);
+                }
+            }
+        }
+    }
+}
+
+bool gen_extend_near(Crossword *cw, C Dictionary *dict, C size_t start, C size_t end,
+                     C u8 category, C Gen_Focus *focus, u32 **matches)
+{
+    if (cw_num_entries(cw) >= CW_MAX_ENTRIES)
+        return false;
+
+    Gen_Frontier frontier;
+    gen_frontier(&frontier, cw, focus);
+    bool placed = false;
+
+    for (size_t i = 0; !placed && i < frontier.count; ++i)
+    {
+        C Gen_Frontier_Point *p = frontier.points + i;
+        C char letter = cw->cells[p->y][p->x].correct_letter;
+        C i16 at = p->vertical ? p->y : p->x;
+
+        for (size_t attempt = 0; !placed && attempt < GEN_ATTEMPTS_PER_POINT; ++attempt)
+        {
+            // ask the dictionary for words with the crossing letter at a random position, in
+            // the spot that keeps the word on the board
+            C i16 length = (i16)rng_range(&cw->rng, GEN_MIN_GROWTH_LENGTH, GEN_MAX_GROWTH_LENGTH);
+            C i16 first = (i16)MAX(0, at + length - CW_DIM);
+            C i16 last = (i16)MIN(length - 1, at);
+            if (first > last)
+                continue;
+
+            C i16 offset = (i16)rng_range(&cw->rng, first, last);
+            char pattern[GEN_MAX_GROWTH_LENGTH + 1];
+            memset(pattern, DICT_WILDCARD, (size_t)length);
+            pattern[length] = '\0';
+            pattern[offset] = letter;
+
+            da_clear(*matches);
+            C size_t n = dict_match(dict, pattern, start, end, category, matches);
+            for (size_t tries = 0; !placed && n > 0 && tries < GEN_ATTEMPTS_PER_WORD; ++tries)
+            {
+                C u32 word_index = (*matches)[rng_range(&cw->rng, 0, (i32)n - 1)];
+                C i16 x = p->vertical ? p->x : p->x - offset;
+                C i16 y = p->vertical ? p->y - offset : p->y;
+
+                if (!cw_contains_word(cw, word_index) &&
+                    cw_can_place(cw, words + word_index, x, y, p->vertical))
+                {
+                    cw_add_entry(cw, word_index, x, y, p->vertical, (u8)rng_range(&cw->rng, 0, 2));
+                    placed = true;
+                }
+            }
+        }
+    }
+
+    return placed;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+size_t gen_puzzle(Crossword *cw, C size_t start, C size_t end, C size_t target_entries)
+{
+    cw_clear(cw);
+
+    // the first word anchors the puzzle, so prefer something with a decent number of letters to
+    // cross
+    for (size_t attempt = 0; cw_num_entries(cw) == 0 && attempt < GEN_ATTEMPTS_PER_WORD; ++attempt)
+    {
+        C Word *w = words + gen_random_word(cw, start, end);
+        if (w->word_length >= 5 || attempt == GEN_ATTEMPTS_PER_WORD - 1)
+        {
+            cw_place_word(cw, w, false);
+        }
+    }
+
+    // none of the picks went on the board, so take the next word along that can
+    if (cw_num_entries(cw) == 0)
+    {
+        C size_t first = gen_random_word(cw, start, end) - start;
+        for (size_t i = 0; cw_num_entries(cw) == 0 && i < end - start; ++i)
+        {
+            cw_place_word(cw, words + start + (first + i) % (end - start), false);
+        }
+    }
+
+    gen_grow(cw, start, end, target_entries);
+    return cw_num_entries(cw);
+}
+
+size_t gen_lattice_puzzle(Crossword *cw, C Dictionary *dict, Fill_Table *table, C size_t start,
+                          C size_t end, C u8 category, C size_t size, C size_t target_entries,
+                          C u64 node_limit)
+{
+    C size_t length = 2 * size - 1;
+    assert(size >= 1 && length <= CW_DIM && 2 * size <= GEN_MAX_LATTICE_SLOTS);
+    cw_clear(cw);
+
+    // across words sit on every other row and down words on every other column, so each across
+    // word crosses every down word and no two parallel words touch
+    C i16 origin = (i16)((CW_DIM - length) / 2);
+    Fill_Slot slots[GEN_MAX_LATTICE_SLOTS];
+    u32 fill_words[GEN_MAX_LATTICE_SLOTS];
+    for (size_t i = 0; i < size; ++i)
+    {
+        C i16 offset = (i16)(origin + 2 * i);
+        slots[i] = (Fill_Slot){origin, offset, false, (u8)length};
+        slots[size + i] = (Fill_Slot){offset, origin, true, (u8)length};
+    }
+
+    Fill f = {0};
+    f.dict = dict;
+    f.start = start;
+    f.end = end;
+    f.category = category;
+    f.slots = slots;
+    f.slot_count = 2 * size;
+    f.table = table;
+    f.node_limit = node_limit;
+    f.rng = cw->rng;
+    f.words = fill_words;
+
+    C bool solved = fill_solve(&f);
+    cw->rng = f.rng;
+    if (!solved)
+        return 0;
+
+    for (size_t i = 0; i < f.slot_count; ++i)
+    {
+        assert(cw_can_place(cw, words + fill_words[i], slots[i].x, slots[i].y, slots[i].vertical));
+        cw_add_entry(cw, fill_words[i], slots[i].x, slots[i].y, slots[i].vertical,
+                     (u8)rng_range(&cw->rng, 0, 2));
+    }
+
+    if (category == DICT_ANY_CATEGORY)
+    {
+        gen_grow(cw, start, end, target_entries);
+        return cw_num_entries(cw);
+    }
+
+    // gen_grow draws from every word, so themed puzzles grow through the dictionary instead
+    C Gen_Focus focus = {CW_DIM / 2, CW_DIM / 2, 0, 0, CW_DIM - 1, CW_DIM - 1};
+    u32 *matches = (u32 *)da_init(sizeof(u32), 64);
+    for (size_t i = cw_num_entries(cw); i < target_entries; ++i)
+    {
+        if (!gen_extend_near(cw, dict, start, end, category, &focus, &matches))
+            break;
+    }
+
+    da_cleanup(matches);
+    return cw_num_entries(cw);
+}
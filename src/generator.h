@@ -0,0 +1,52 @@
+#ifndef _GENERATOR_
+#define _GENERATOR_
+
+#include <stddef.h>
+
+#include "crossword.h"
+#include "dictionary.h"
+#include "fill.h"
+
+// `words` is sorted by surprisal, so a difficulty band is a contiguous range of the dictionary.
+// This splits the dictionary into `band_count` equally sized bands, easiest first.
+extern void gen_band_range(const size_t band, const size_t band_count, size_t *start, size_t *end);
+
+// Clears the crossword and fills it with up to `target_entries` words drawn from
+// words[start, end). Returns the number of entries that were placed, which is only 0 when no word
+// in the range can go on the board.
+extern size_t gen_puzzle(Crossword *cw, const size_t start, const size_t end,
+                         const size_t target_entries);
+
+// Clears the crossword and fills a `size` x `size` lattice of interlocking words in the middle of
+// it (every other row across, every other column down, all 2 * size - 1 letters long) from
+// words[start, end), then grows it with gen_extend up to `target_entries`. Returns the number of
+// entries, or 0 if the lattice couldn't be filled within `node_limit` search nodes. `table` may be
+// NULL, or shared between any threads (see fill.h).
+//
+// With a `category` other than DICT_ANY_CATEGORY, every word is of that category, and the puzzle
+// grows with gen_extend_near from the middle of the board instead.
+extern size_t gen_lattice_puzzle(Crossword *cw, const Dictionary *dict, Fill_Table *table,
+                                 const size_t start, const size_t end, const u8 category,
+                                 const size_t size, const size_t target_entries,
+                                 const u64 node_limit);
+
+// Tries to add one more word from words[start, end) to the crossword. Returns true on success.
+extern bool gen_extend(Crossword *cw, const size_t start, const size_t end);
+
+// Where the player is looking, in cells: the selected cell and the visible part of the board.
+typedef struct
+{
+    i16 x, y;
+    i16 view_min_x, view_min_y, view_max_x, view_max_y;
+} Gen_Focus;
+
+// Like gen_extend, but grows the board where the player will see it, with words of `category`
+// (or DICT_ANY_CATEGORY). Letters that only belong to one entry are the points a new word can
+// cross; they are tried closest to the focus first, with anything off screen pushed to the back.
+// `matches` is a dynamic array of u32 that's only used as scratch, kept by the caller so that it
+// can be reused from call to call.
+extern bool gen_extend_near(Crossword *cw, const Dictionary *dict, const size_t start,
+                            const size_t end, const u8 category, const Gen_Focus *focus,
+                            u32 **matches);
+
+#endif
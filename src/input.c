@@ -0,0 +1,108 @@
+#include "input.h"
+
+#include <string.h>
+
+#include "mem.h"
+#include "raylib.h"
+
+#define GLFW_INCLUDE_NONE
+#include "external/glfw/include/GLFW/glfw3.h"
+
+// see main.c
+#define C const
+
+#define INPUT_START_CAPACITY 64
+
+// GLFW callbacks don't carry any user data
+static Input_Queue *input_hooked = NULL;
+static GLFWkeyfun input_chained = NULL;
+
+static void input_push(Input_Queue *q, C int key, C double time)
+{
+    if (q->count == q->capacity)
+    {
+        C size_t capacity = q->capacity * 2;
+        Input_Key *keys =
+            (Input_Key *)mem_realloc(MEM_INPUT, q->keys, capacity * sizeof(Input_Key));
+
+        // unwrap, so the keys after the end of the old buffer follow on in the new one
+        memcpy(keys + q->capacity, keys, q->head * sizeof(Input_Key));
+        q->keys = keys;
+        q->capacity = capacity;
+    }
+
+    Input_Key *k = q->keys + ((q->head + q->count) & (q->capacity - 1));
+    k->key = key;
+    k->time = time;
+    ++q->count;
+}
+
+static void input_key_callback(GLFWwindow *window, int key, int scancode, int action, int mods)
+{
+    if (input_chained)
+    {
+        input_chained(window, key, scancode, action, mods);
+    }
+
+    // same as raylib's queue, repeats aren't presses
+    if (input_hooked && action == GLFW_PRESS && key > 0)
+    {
+        input_push(input_hooked, key, GetTime());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void input_init(Input_Queue *q, C bool hook)
+{
+    memset(q, 0, sizeof(Input_Queue));
+    q->capacity = INPUT_START_CAPACITY;
+    q->keys = (Input_Key *)mem_alloc(MEM_INPUT, q->capacity * sizeof(Input_Key));
+
+    GLFWwindow *window = glfwGetCurrentContext();
+    if (hook && window && !input_hooked)
+    {
+        input_chained = glfwSetKeyCallback(window, input_key_callback);
+        input_hooked = q;
+        q->hooked = true;
+    }
+}
+
+void input_cleanup(Input_Queue *q)
+{
+    if (q->hooked)
+    {
+        glfwSetKeyCallback(glfwGetCurrentContext(), input_chained);
+        input_hooked = NULL;
+        input_chained = NULL;
+    }
+
+    mem_free(q->keys);
+}
+
+void input_poll(Input_Queue *q)
+{
+    if (q->hooked)
+        return;
+
+    C double now = GetTime();
+    for (int key = GetKeyPressed(); key != 0; key = GetKeyPressed())
+    {
+        input_push(q, key, now);
+    }
+}
+
+bool input_pop(Input_Queue *q, Input_Key *key)
+{
+    if (q->count == 0)
+        return false;
+
+    *key = q->keys[q->head];
+    q->head = (q->head + 1) & (q->capacity - 1);
+    --q->count;
+    return true;
+}
+
+void input_inject(Input_Queue *q, C int key)
+{
+    input_push(q, key, GetTime());
+}
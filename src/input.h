@@ -0,0 +1,45 @@
+#ifndef _INPUT_
+#define _INPUT_
+
+#include <stddef.h>
+
+#include "common.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Key presses, in order, with when they came in. raylib's own queue (GetKeyPressed) holds 16 keys
+// a frame, drops the rest, and shifts every key down on each pop, so a long frame loses letters
+// from anyone typing quickly. Instead, the key callback of raylib's GLFW window is chained so that
+// every press also lands here, in a ring buffer that grows as needed.
+//
+// Without a GLFW window (or when hooking is turned off, e.g., for replays, whose keys go straight
+// into raylib's queue) keys are taken from GetKeyPressed once a frame instead.
+typedef struct
+{
+    int key;     // raylib KeyboardKey
+    double time; // GetTime() when the press was polled, GLFW doesn't say when it happened
+} Input_Key;
+
+typedef struct
+{
+    Input_Key *keys;
+    size_t capacity; // power of 2
+    size_t head;
+    size_t count;
+    bool hooked;
+} Input_Queue;
+
+// After the window is opened. Only one queue can be hooked at a time.
+extern void input_init(Input_Queue *q, const bool hook);
+extern void input_cleanup(Input_Queue *q);
+
+// Once a frame, before popping.
+extern void input_poll(Input_Queue *q);
+
+// Oldest key first. Returns false when there are none left.
+extern bool input_pop(Input_Queue *q, Input_Key *key);
+
+// Queues a key as if it was pressed now, for anything playing the game that isn't a keyboard
+// (see soak.h).
+extern void input_inject(Input_Queue *q, const int key);
+
+#endif
@@ -0,0 +1,106 @@
+#include "latency.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "dynamic_array.h"
+#include "raylib.h"
+
+// see main.c
+#define C const
+
+// upper end of the bucket the `fraction` of samples fall under, or the slowest sample if lower
+static double latency_percentile(C Latency *l, C double fraction)
+{
+    C u32 wanted = (u32)(fraction * (double)l->count);
+    u32 seen = 0;
+    for (size_t i = 0; i < LATENCY_BUCKETS - 1; ++i)
+    {
+        seen += l->buckets[i];
+        if (seen > wanted)
+            return MIN((double)(i + 1) * LATENCY_BUCKET_MS, l->max * 1000);
+    }
+
+    return l->max * 1000;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void latency_init(Latency *l, C char *path)
+{
+    memset(l, 0, sizeof(Latency));
+    l->path = path;
+    if (path)
+    {
+        l->pending = (double *)da_init(sizeof(double), 16);
+    }
+}
+
+void latency_close(Latency *l)
+{
+    if (!l->path)
+        return;
+
+    da_cleanup(l->pending);
+
+    FILE *file = fopen(l->path, "w");
+    if (!file)
+    {
+        fprintf(stderr, "Unable to write %s\n", l->path);
+        return;
+    }
+
+    fprintf(file, "# key press to end of frame latency, %u keys\n", l->count);
+    if (l->count > 0)
+    {
+        fprintf(file, "# mean %.3f  p50 %.1f  p90 %.1f  p99 %.1f  max %.3f ms\n",
+                1000 * l->total / l->count, latency_percentile(l, 0.5),
+                latency_percentile(l, 0.9), latency_percentile(l, 0.99), 1000 * l->max);
+    }
+
+    fprintf(file, "# from_ms to_ms keys\n");
+    for (size_t i = 0; i < LATENCY_BUCKETS; ++i)
+    {
+        if (l->buckets[i] == 0)
+            continue;
+
+        C double from = (double)i * LATENCY_BUCKET_MS;
+        if (i == LATENCY_BUCKETS - 1)
+        {
+            fprintf(file, "%.1f inf %u\n", from, l->buckets[i]);
+        }
+        else
+        {
+            fprintf(file, "%.1f %.1f %u\n", from, from + LATENCY_BUCKET_MS, l->buckets[i]);
+        }
+    }
+
+    fclose(file);
+}
+
+void latency_key(Latency *l, C double time)
+{
+    if (l->path)
+    {
+        *(double *)da_append((void **)&l->pending) = time;
+    }
+}
+
+void latency_frame_end(Latency *l)
+{
+    if (!l->path || da_length(l->pending) == 0)
+        return;
+
+    C double now = GetTime();
+    for (size_t i = 0; i < da_length(l->pending); ++i)
+    {
+        C double seconds = MAX(0, now - l->pending[i]);
+        C size_t bucket = (size_t)(seconds * 1000 / LATENCY_BUCKET_MS);
+
+        ++l->buckets[MIN(bucket, LATENCY_BUCKETS - 1)];
+        ++l->count;
+        l->total += seconds;
+        l->max = MAX(l->max, seconds);
+    }
+
+    da_clear(l->pending);
+}
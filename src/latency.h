@@ -0,0 +1,40 @@
+#ifndef _LATENCY_
+#define _LATENCY_
+
+#include "common.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// How long it takes from a key press to the end of the frame that shows it, i.e., the latency the
+// player feels. Keys take effect in the frame that pops them from the input queue (see input.h),
+// so every key popped in a frame is measured when that frame's EndDrawing returns. That includes
+// the buffer swap and raylib's wait for the next frame, but not the time the GPU and display take
+// to actually put it on screen.
+//
+// The results are written as a histogram when the game closes, so they can be compared release
+// over release.
+#define LATENCY_BUCKET_MS 0.5
+#define LATENCY_BUCKETS 200 // the last one also holds everything slower
+
+typedef struct
+{
+    const char *path; // NULL when not measuring
+    u32 buckets[LATENCY_BUCKETS];
+    u32 count;
+    double total;
+    double max;
+    double *pending; // key times in this frame (dynamic array)
+} Latency;
+
+// `path` is where the histogram is written, NULL to measure nothing.
+extern void latency_init(Latency *l, const char *path);
+
+// Writes the histogram.
+extern void latency_close(Latency *l);
+
+// A key (see Input_Key) was handled this frame.
+extern void latency_key(Latency *l, const double time);
+
+// Right after EndDrawing.
+extern void latency_frame_end(Latency *l);
+
+#endif
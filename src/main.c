@@ -10,8 +10,26 @@
 #include "raylib.h"
 
 #include "block_centered_text.h"
-#include "clues.h"
+#include "board_cache.h"
+#include "board_immediate.h"
+#include "board_mesh.h"
+#include "board_overview.h"
+#include "board_shader.h"
 #include "common.h"
+#include "crossword.h"
+#include "dictionary.h"
+#include "generator.h"
+#include "input.h"
+#include "latency.h"
+#include "mem.h"
+#include "profile.h"
+#include "puzzle_pack.h"
+#include "replay.h"
+#include "save.h"
+#include "skill.h"
+#include "snapshot.h"
+#include "soak.h"
+#include "speculate.h"
 
 // One gripe I have is that the line `C size_t i` takes 14 characters: a lot of typing. So, I'm
 // going to try and make it a bit easier on myself by just having an upper case 'C' to represent.
@@ -23,67 +41,404 @@
 ADJUST_GLOBAL_CONST_INT(g_cell_width, 48);
 ADJUST_GLOBAL_CONST_INT(g_cell_height, 48);
 
-ADJUST_GLOBAL_CONST_FLOAT(g_min_zoom, 0.5f);
+ADJUST_GLOBAL_CONST_FLOAT(g_min_zoom, 0.1f);
 ADJUST_GLOBAL_CONST_FLOAT(g_max_zoom, 1.1f);
 
-#define CW_DIM 50
-#define CW_MAX_ENTRIES 50
+ADJUST_GLOBAL_CONST_FLOAT(g_autosave_seconds, 10.f);
+
+// how the board is drawn, see board_shader.h, board_cache.h, board_mesh.h and board_immediate.h.
+// Anything that isn't supported where the game is running falls back to the mesh, and the mesh to
+// immediate mode.
+#define BOARD_SHADER 0
+#define BOARD_CACHE 1
+#define BOARD_MESH 2
+#define BOARD_IMMEDIATE 3
+#define BOARD_OVERVIEW 4 // not selectable, used when zoomed out (see g_overview_cell_pixels)
+ADJUST_GLOBAL_CONST_INT(g_board_renderer, 0); // a literal, adjust.h reads it back from here
+
+// Level of detail, by how many pixels a cell takes up on screen. Below g_letter_cell_pixels the
+// letters are too small to read and aren't drawn. Below g_overview_cell_pixels the board is drawn
+// with one pixel per cell (see board_overview.h).
+ADJUST_GLOBAL_CONST_INT(g_letter_cell_pixels, 16);
+ADJUST_GLOBAL_CONST_INT(g_overview_cell_pixels, 8);
+
+// words added around the player every time they finish an entry
+ADJUST_GLOBAL_CONST_INT(g_growth_per_entry, 2);
+
+// lower the resolution the board is drawn at while frames go over budget
+ADJUST_GLOBAL_CONST_BOOL(g_dynamic_resolution, false);
+ADJUST_GLOBAL_CONST_FLOAT(g_min_resolution_scale, 0.5f);
+
+// stop at the end of any frame that allocated on the main thread without the board growing
+// (see mem.h)
+ADJUST_GLOBAL_CONST_BOOL(g_assert_no_frame_allocations, false);
+
+#define PUZZLE_PACK_PATH "puzzles.pack"
+#define SAVE_PATH "crossword.sav"
+#define STARTING_BAND 0
+#define STARTING_BAND_COUNT 8
+#define STARTING_ENTRIES 12
+
+#define TARGET_FPS 60
+#define RESOLUTION_STEP 0.125f
+#define RESOLUTION_COOLDOWN 30 // frames between resolution changes, so they don't flicker
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-// Structures for defining the crossword grid that expands as the player plays the game.
-typedef struct
+// where the player is looking, in cells, for growing the board around them
+static Gen_Focus view_focus(C Camera2D camera, C Cell *selected, C int width, C int height)
+{
+    C Vector2 view_min = GetScreenToWorld2D((Vector2){0, 0}, camera);
+    C Vector2 view_max = GetScreenToWorld2D((Vector2){(float)width, (float)height}, camera);
+
+    Gen_Focus focus;
+    focus.x = selected->x;
+    focus.y = selected->y;
+    focus.view_min_x = (i16)MAX(0, view_min.x / g_cell_width);
+    focus.view_min_y = (i16)MAX(0, view_min.y / g_cell_height);
+    focus.view_max_x = (i16)MIN(CW_DIM - 1, view_max.x / g_cell_width);
+    focus.view_max_y = (i16)MIN(CW_DIM - 1, view_max.y / g_cell_height);
+    return focus;
+}
+
+// Grows the board after `entry` was finished. The growth is normally already worked out in the
+// background; only when it isn't (e.g., the player finished two entries back to back) is it done
+// here, around the selected cell.
+static void grow_board(Crossword *cw, Speculator *spec, C Dictionary *dict, C u16 entry,
+                       C u32 entries_version, C Gen_Focus *focus, C size_t start, C size_t end,
+                       u32 **matches)
 {
-    char *word;
-    char *clue_str;
-    bool complete;
-    size_t word_length;
-    i16 start_x, start_y;
-    i16 dir_x, dir_y;
-} Crossword_Entry;
+    if (spec_commit(spec, cw, entry, entries_version))
+        return;
 
+    for (int i = 0; i < g_growth_per_entry; ++i)
+    {
+        gen_extend_near(cw, dict, start, end, DICT_ANY_CATEGORY, focus, matches);
+    }
+}
+
+// Moves on to a new puzzle from words[start, end), from the pack's band closest to it or generated
+// now when there's no pack, and returns the cell to start on.
+static Cell *new_puzzle(Crossword *cw, C Puzzle_Pack *pack, C size_t start, C size_t end)
+{
+    bool loaded = false;
+    if (pack->data)
+    {
+        C size_t count = pack_band_count(pack);
+        C size_t band = MIN((start + end) / 2 * count / words_count, count - 1);
+        C size_t index = (size_t)rng_range(&cw->rng, 0, INT32_MAX);
+        loaded = pack_load_puzzle(pack, band, index, cw) && cw_num_entries(cw) > 0;
+    }
+
+    // a board without entries has no cell to start on, which only happens when no word in the band
+    // can go on the board
+    if (!loaded && gen_puzzle(cw, start, end, STARTING_ENTRIES) == 0 &&
+        gen_puzzle(cw, 0, words_count, STARTING_ENTRIES) == 0)
+    {
+        fprintf(stderr, "No word in clues.h fits on the board.\n");
+        exit(1);
+    }
+
+    Cell *c = &cw->cells[cw->entries->start_y][cw->entries->start_x];
+    cw->vertical_mode = c->horizontal_entry == CW_NO_ENTRY;
+    return c;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// The board is normally drawn straight to the screen at the window's native resolution. With
+// dynamic resolution on, running over the frame budget lowers the scale the board is drawn at
+// (into `target`, which is then stretched over the window), and it goes back up once frames have
+// room to spare. The title and clue are always drawn at native resolution so text stays sharp.
 typedef struct
 {
-    i16 x, y;
-    char user_letter;
-    char correct_letter;
-    bool locked;
-    Crossword_Entry *horizontal_entry;
-    Crossword_Entry *vertical_entry;
-} Cell;
+    float scale;
+    float frame_time; // smoothed seconds per frame, including the wait for the next one
+    float work_time;  // smoothed seconds per frame spent on the frame itself
+    int cooldown;
+    RenderTexture2D target; // only loaded while the scale is below 1
+    bool no_target;         // render textures aren't supported (e.g., the software renderer)
+} Resolution;
+
+static void resolution_update(Resolution *r, C float frame_time, C float work_time)
+{
+    C float budget = 1.f / TARGET_FPS;
+    r->frame_time += (frame_time - r->frame_time) * 0.1f;
+    r->work_time += (work_time - r->work_time) * 0.1f;
+
+    float scale = r->scale;
+    if (!g_dynamic_resolution || r->no_target)
+    {
+        scale = 1;
+    }
+    else if (r->cooldown > 0)
+    {
+        --r->cooldown;
+    }
+    else if (r->frame_time > budget * 1.1f)
+    {
+        scale = MAX(g_min_resolution_scale, scale - RESOLUTION_STEP);
+    }
+    else if (r->work_time < budget * 0.5f)
+    {
+        scale = MIN(1.f, scale + RESOLUTION_STEP);
+    }
+
+    if (scale != r->scale)
+    {
+        r->scale = scale;
+        r->cooldown = RESOLUTION_COOLDOWN;
+    }
+}
+
+// Keeps the target the scaled size of the window, or unloaded at native resolution.
+static void resolution_fit_target(Resolution *r, C int screen_width, C int screen_height)
+{
+    C int width = r->scale < 1 ? MAX(1, (int)(screen_width * r->scale)) : 0;
+    C int height = r->scale < 1 ? MAX(1, (int)(screen_height * r->scale)) : 0;
+    if (width == r->target.texture.width && height == r->target.texture.height)
+        return;
+
+    if (r->target.id != 0)
+    {
+        UnloadRenderTexture(r->target);
+        r->target = (RenderTexture2D){0};
+    }
+
+    if (width > 0)
+    {
+        r->target = LoadRenderTexture(width, height);
+        SetTextureFilter(r->target.texture, TEXTURE_FILTER_BILINEAR);
+        r->no_target = r->target.id == 0;
+    }
+}
 
 typedef struct
 {
-    Crossword_Entry entries[CW_MAX_ENTRIES];
-    i16 min_x, max_x, min_y, max_y;
-    size_t num_entries;
-    Cell cells[CW_DIM][CW_DIM];
-    bool vertical_mode;
-} Crossword;
+    int active; // one of the BOARD_ defines
+    bool letters;
+    Board_Shader shader;
+    Board_Cache cache;
+    Board_Mesh mesh;
+    Board_Overview overview;
+} Board_Renderer;
+
+static void board_renderer_init(Board_Renderer *r)
+{
+    board_shader_init(&r->shader);
+    board_cache_init(&r->cache);
+    board_mesh_init(&r->mesh);
+    board_overview_init(&r->overview);
+}
+
+static void board_renderer_cleanup(Board_Renderer *r)
+{
+    board_shader_cleanup(&r->shader);
+    board_cache_cleanup(&r->cache);
+    board_mesh_cleanup(&r->mesh);
+    board_overview_cleanup(&r->overview);
+}
+
+// Picks the renderer for this frame and brings it up to date. Only the active one is updated; the
+// others catch up from the tile versions if they're switched to. `cell_pixels` is the size of a
+// cell on screen.
+static void board_renderer_update(Board_Renderer *r, C Crossword *cw, C Cell *selected,
+                                  C float cell_pixels)
+{
+    r->active = g_board_renderer;
+    if ((r->active == BOARD_SHADER && !r->shader.supported) ||
+        (r->active == BOARD_CACHE && !r->cache.supported) || r->active < 0 ||
+        r->active > BOARD_IMMEDIATE)
+    {
+        r->active = BOARD_MESH;
+    }
+
+    if (r->active == BOARD_MESH && !r->mesh.supported)
+    {
+        r->active = BOARD_IMMEDIATE;
+    }
+
+    // cached tiles have their letters baked in
+    r->letters = cell_pixels >= (float)g_letter_cell_pixels;
+    if (!r->letters && r->active == BOARD_CACHE)
+    {
+        r->active = r->mesh.supported ? BOARD_MESH : BOARD_IMMEDIATE;
+    }
 
-static void cw_validate_entry(Crossword *cw, Crossword_Entry *ce);
-static bool cw_place_word(Crossword *cw, C Word *w, C bool vertical);
+    if (cell_pixels < (float)g_overview_cell_pixels)
+    {
+        r->active = BOARD_OVERVIEW;
+    }
+
+    switch (r->active)
+    {
+    case BOARD_SHADER:
+        board_shader_update(&r->shader, cw, g_cell_width, g_cell_height);
+        break;
+    case BOARD_CACHE:
+        board_cache_update(&r->cache, cw, g_cell_width, g_cell_height);
+        break;
+    case BOARD_OVERVIEW:
+        board_overview_update(&r->overview, cw);
+        break;
+    case BOARD_IMMEDIATE:
+        break;
+    default:
+        board_mesh_update(&r->mesh, cw, selected, g_cell_width, g_cell_height);
+        break;
+    }
+}
+
+static void board_renderer_draw(C Board_Renderer *r, C Crossword *cw, C Cell *selected)
+{
+    switch (r->active)
+    {
+    case BOARD_SHADER:
+        board_shader_draw(&r->shader, selected, r->letters);
+        break;
+    case BOARD_CACHE:
+        board_cache_draw(&r->cache, selected);
+        break;
+    case BOARD_OVERVIEW:
+        board_overview_draw(&r->overview, selected, g_cell_width, g_cell_height);
+        break;
+    case BOARD_IMMEDIATE:
+        board_immediate_draw(cw, selected, g_cell_width, g_cell_height, r->letters);
+        break;
+    default:
+        board_mesh_draw(&r->mesh, r->letters);
+        break;
+    }
+}
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-int main(void)
+static void usage(C char *name)
+{
+    fprintf(stderr,
+            "usage: %s [--record session.rae [--seed seed] | --replay session.rae [--headless] | "
+            "--soak seconds [--seed seed]] [--latency latency.txt]\n",
+            name);
+    exit(1);
+}
+
+int main(int argc, char **argv)
 {
-    C int texture_width = 1080;
-    C int texture_height = 720;
+    int replay_mode = REPLAY_OFF;
+    C char *replay_path = NULL;
+    C char *latency_path = NULL;
+    u64 seed = (u64)time(NULL);
+    bool headless = false;
+    double soak_seconds = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        C char *flag = argv[i];
+        if (strcmp(flag, "--headless") == 0)
+        {
+            headless = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+            usage(argv[0]);
 
-    InitWindow(texture_width, texture_height, "Crossword");
+        C char *value = argv[++i];
+        if (strcmp(flag, "--record") == 0 && replay_mode == REPLAY_OFF)
+        {
+            replay_mode = REPLAY_RECORD;
+            replay_path = value;
+        }
+        else if (strcmp(flag, "--replay") == 0 && replay_mode == REPLAY_OFF)
+        {
+            replay_mode = REPLAY_PLAY;
+            replay_path = value;
+        }
+        else if (strcmp(flag, "--seed") == 0)
+            seed = strtoull(value, NULL, 10);
+        else if (strcmp(flag, "--latency") == 0)
+            latency_path = value;
+        else if (strcmp(flag, "--soak") == 0)
+            soak_seconds = strtod(value, NULL);
+        else
+            usage(argv[0]);
+    }
+
+    if (headless && replay_mode != REPLAY_PLAY)
+        usage(argv[0]);
+
+    // soaks are headless too, and never touch the save either
+    if (soak_seconds > 0)
+    {
+        if (replay_mode != REPLAY_OFF)
+            usage(argv[0]);
+
+        headless = true;
+    }
+
+    // recording and replaying start from a new puzzle and never touch the save
+    Replay replay;
+    if (!replay_open(&replay, replay_mode, replay_path, seed))
+        return 1;
+
+    C bool replaying = replay.mode != REPLAY_OFF;
+    C bool saving = !replaying && soak_seconds <= 0;
+
+    // headless replays and soaks run in a hidden window as fast as they can
+    if (headless)
+    {
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    }
+
+    InitWindow(1080, 720, "Crossword");
     SetWindowState(FLAG_WINDOW_RESIZABLE);
-    SetTargetFPS(60);
-    SetRandomSeed(time(NULL));
+    SetTargetFPS(headless ? 0 : TARGET_FPS);
+    SetRandomSeed((unsigned int)replay.seed);
 
     // TODO: only update on event?
 
-    Crossword crossword = {0};
+    Dictionary dictionary;
+    dict_init(&dictionary);
+
+    Crossword crossword;
+    cw_init(&crossword);
+    rng_seed(&crossword.rng, replay.seed);
 
-    cw_place_word(&crossword, words + 3, false);
-    cw_place_word(&crossword, words + 100, true);
-    // cw_place_word(&crossword, words + 20);
+    // resume the last game if there is one. Otherwise, use a precomputed puzzle when there is a
+    // pack, and generate one now when there isn't
+    i16 selected_x = 0, selected_y = 0;
+    C bool resumed = saving && save_load(SAVE_PATH, &crossword, &selected_x, &selected_y);
 
-    Cell *selected_cell = &crossword.cells[crossword.entries->start_y][crossword.entries->start_x];
-    crossword.vertical_mode = selected_cell->horizontal_entry == NULL;
+    Puzzle_Pack pack = {0};
+    if (!resumed)
+    {
+        pack_open(&pack, PUZZLE_PACK_PATH);
+    }
+
+    // the board grows from the words the player is good for (see skill.h). Recordings and replays
+    // time keys by frame, so that they move the band the same way
+    size_t band_start, band_end;
+    gen_band_range(STARTING_BAND, STARTING_BAND_COUNT, &band_start, &band_end);
+
+    Skill skill;
+    skill_init(&skill, band_start, band_end, replaying ? 0 : GetTime());
+
+    Cell *selected_cell;
+    if (resumed)
+    {
+        selected_cell = &crossword.cells[selected_y][selected_x];
+    }
+    else
+    {
+        selected_cell = new_puzzle(&crossword, &pack, skill.band_start, skill.band_end);
+    }
+
+    // anything off the main thread (autosave) reads the board through published snapshots
+    Snapshot_Publisher *publisher = snapshot_publisher_create();
+    snapshot_publish(publisher, &crossword);
+
+    Autosave *autosave = autosave_create(SAVE_PATH, publisher);
+    Speculator *speculator = spec_create(publisher, &dictionary);
+    u32 *growth_matches = (u32 *)da_init(sizeof(u32), 64); // grow_board's, kept between entries
+    bool board_changed = false;
+    double last_save_time = GetTime();
 
     int min_x, max_x, min_y, max_y;
     min_x = -300;
@@ -96,28 +451,80 @@ int main(void)
     camera.target.x = g_cell_width * CW_DIM / 2.f - 250;
     camera.target.y = g_cell_height * CW_DIM / 2.f - 250;
 
-    RenderTexture2D target = LoadRenderTexture(texture_width, texture_height);
+    Resolution resolution = {0};
+    resolution.scale = 1;
+
+    Board_Renderer board_renderer;
+    board_renderer_init(&board_renderer);
 
+    // replayed keys go straight into raylib's queue, so they're read from there
+    Input_Queue input;
+    input_init(&input, replay.mode != REPLAY_PLAY);
+
+    Latency latency;
+    latency_init(&latency, latency_path);
+
+    Soak soak;
+    soak_init(&soak, soak_seconds, replay.seed);
+
+    // centered on the window, so laid out again whenever its width changes
     Block_Centered_Text title;
-    block_centered_text_init(&title, (char *)"Crossword", 40, 20, WHITE, texture_width, 5, BLACK);
+    int title_width = 0;
 
     ///////////////////////////////////////////////////////////////////////////////////////////////
-    // Set up adjustables
-    adjust_init();
+    // Set up adjustables and the profiler
+    adjust_init_with_allocator(mem_hook_alloc, mem_hook_realloc, mem_hook_free,
+                               (void *)(intptr_t)MEM_ADJUST);
+    profile_init();
     ADJUST_CONST_FLOAT(mouse_scroll_mitigator, 0.002f);
 
     adjust_register_global_int(g_cell_width);
     adjust_register_global_int(g_cell_height);
     adjust_register_global_float(g_min_zoom);
     adjust_register_global_float(g_max_zoom);
+    adjust_register_global_float(g_autosave_seconds);
+    adjust_register_global_int(g_board_renderer);
+    adjust_register_global_int(g_letter_cell_pixels);
+    adjust_register_global_int(g_overview_cell_pixels);
+    adjust_register_global_int(g_growth_per_entry);
+    adjust_register_global_bool(g_dynamic_resolution);
+    adjust_register_global_float(g_min_resolution_scale);
+    adjust_register_global_bool(g_assert_no_frame_allocations);
 
     ///////////////////////////////////////////////////////////////////////////////////////////////
     // Run the game
-    while (!WindowShouldClose())
+    replay_begin(&replay);
+    while (!WindowShouldClose() && !replay_done(&replay) && !soak_done(&soak))
     {
+        mem_frame_begin();
+        C u32 frame_entries_version = crossword.entries_version;
+
+        PROFILE_BEGIN("adjust");
         adjust_update();
+        PROFILE_END();
+
+        replay_frame_begin(&replay);
+
+        // the soak's bot plays through the same keyboard handling as the player
+        C int soak_pressed = soak_key(&soak, &crossword, selected_cell);
+        if (soak_pressed == SOAK_NEW_PUZZLE)
+        {
+            selected_cell = new_puzzle(&crossword, &pack, skill.band_start, skill.band_end);
+            soak_new_puzzle(&soak);
+        }
+        else if (soak_pressed != 0)
+        {
+            input_inject(&input, soak_pressed);
+        }
+
+        C double frame_start = GetTime();
+        bool entry_completed = false;
+
+        C int screen_width = GetScreenWidth();
+        C int screen_height = GetScreenHeight();
 
         // handle mouse input
+        PROFILE_SCOPE("mouse input")
         {
             // click and drag to move the camera around
             if (IsMouseButtonDown(MOUSE_LEFT_BUTTON) || IsMouseButtonDown(MOUSE_MIDDLE_BUTTON) ||
@@ -147,9 +554,9 @@ int main(void)
 
                     if (next_cell == selected_cell)
                     {
-                        crossword.vertical_mode = crossword.vertical_mode
-                                                      ? selected_cell->horizontal_entry != NULL
-                                                      : selected_cell->vertical_entry != NULL;
+                        crossword.vertical_mode =
+                            cw_cell_entry(&crossword, selected_cell, !crossword.vertical_mode) !=
+                            NULL;
                     }
                     else
                     {
@@ -163,22 +570,46 @@ int main(void)
             camera.zoom = MAX(MIN(camera.zoom, g_max_zoom), g_min_zoom);
         }
 
+        C Gen_Focus focus = view_focus(camera, selected_cell, screen_width, screen_height);
+
         // handle keyboard input
+        PROFILE_SCOPE("keyboard input")
         {
-            int key = GetKeyPressed();
-            while (key != 0)
+            input_poll(&input);
+            Input_Key pressed;
+            while (input_pop(&input, &pressed))
             {
+                C int key = pressed.key;
+                C double key_time = replaying ? (double)replay.frame / TARGET_FPS : pressed.time;
+                latency_key(&latency, pressed.time);
                 if (selected_cell->locked == false)
                 {
+                    C u16 entry = crossword.vertical_mode ? selected_cell->vertical_entry
+                                                          : selected_cell->horizontal_entry;
                     if (isalpha(key))
                     {
-                        selected_cell->user_letter = (char)toupper(key);
+                        C char letter = (char)toupper(key);
+                        skill_letter(&skill, entry, letter == selected_cell->correct_letter,
+                                     key_time);
+                        cw_set_user_letter(&crossword, selected_cell, letter);
+                        board_changed = true;
+
+                        Crossword_Entry *e = cw_entry(&crossword, entry);
+                        C u32 entries_version = crossword.entries_version;
+                        if (cw_validate_entry(&crossword, e))
+                        {
+                            entry_completed = true;
+                            skill_finish(&skill, words + e->word_index, key_time);
+
+                            C double grow_start = GetTime();
+                            grow_board(&crossword, speculator, &dictionary, entry,
+                                       entries_version, &focus, skill.band_start,
+                                       skill.band_end, &growth_matches);
+                            soak_grow(&soak, GetTime() - grow_start);
+                        }
 
                         if (crossword.vertical_mode)
                         {
-                            // TODO: do something if valid (function return bool?)
-                            cw_validate_entry(&crossword, selected_cell->vertical_entry);
-
                             C i16 next_y = selected_cell->y + 1;
                             if (next_y < CW_DIM &&
                                 crossword.cells[next_y][selected_cell->x].correct_letter != 0)
@@ -188,9 +619,6 @@ int main(void)
                         }
                         else
                         {
-                            // TODO: do something if valid (function return bool?)
-                            cw_validate_entry(&crossword, selected_cell->horizontal_entry);
-
                             C i16 next_x = selected_cell->x + 1;
                             if (next_x < CW_DIM &&
                                 crossword.cells[selected_cell->y][next_x].correct_letter != 0)
@@ -201,7 +629,9 @@ int main(void)
                     }
                     else if (key == KEY_BACKSPACE)
                     {
-                        selected_cell->user_letter = ' ';
+                        skill_backspace(&skill, entry, key_time);
+                        cw_set_user_letter(&crossword, selected_cell, ' ');
+                        board_changed = true;
 
                         if (crossword.vertical_mode)
                         {
@@ -283,189 +713,141 @@ int main(void)
                 // key == KEY_TAB
                 ////////////////////////////////////////////////////////////////////////////////////
                 ////////////////////////////////////////////////////////////////////////////////////
-
-                key = GetKeyPressed();
             }
         }
 
-        // render state to texture
-        {
-            BeginTextureMode(target);
-            ClearBackground(BLACK);
-
-            BeginMode2D(camera);
+        PROFILE_BEGIN("publish");
+        snapshot_publish(publisher, &crossword);
+        spec_update(speculator, &crossword, &focus, skill.band_start, skill.band_end,
+                    (u32)MAX(0, g_growth_per_entry));
 
-            // render board
-            for (int y = 0; y < CW_DIM; ++y)
+        // autosave in the background as soon as an entry is finished, and every so often while
+        // the player is typing
+        if (saving && board_changed &&
+            (entry_completed || GetTime() - last_save_time > (double)g_autosave_seconds))
+        {
+            if (autosave_request(autosave, selected_cell))
             {
-                for (int x = 0; x < CW_DIM; ++x)
-                {
-                    C Cell *c = &crossword.cells[y][x];
-
-                    if (c->correct_letter != 0)
-                    {
-                        C Color color = c == selected_cell ? (c->locked ? LIGHTGRAY : YELLOW)
-                                                           : (c->locked ? GRAY : WHITE);
-                        DrawRectangle(g_cell_width * x, g_cell_height * y, g_cell_width - 1,
-                                      g_cell_height - 1, color);
-
-                        if (c->user_letter != 0)
-                        {
-                            C char text[2] = {c->user_letter, '\0'};
-                            C int font_size = 40;
-                            DrawText(text, x * g_cell_width + 13, y * g_cell_height + 5, font_size,
-                                     BLACK);
-                        }
-                    }
-                }
+                board_changed = false;
+                last_save_time = GetTime();
             }
+        }
+        PROFILE_END();
 
-            EndMode2D();
-
-            // render title and clue
-            block_centered_text_render(&title);
+        PROFILE_BEGIN("renderer update");
+        board_renderer_update(&board_renderer, &crossword, selected_cell,
+                              (float)MIN(g_cell_width, g_cell_height) * camera.zoom);
+        PROFILE_END();
 
-            DrawRectangle(100, texture_height - 100, texture_width - 200, 100, WHITE);
-            DrawRectangleLinesEx((Rectangle){99, texture_height - 101, texture_width - 198, 106}, 5,
-                                 BLACK);
+        // render the board below native resolution when frames are running long
+        resolution_fit_target(&resolution, screen_width, screen_height);
+        C bool scaled = resolution.target.id != 0;
+        if (scaled)
+        {
+            PROFILE_BEGIN("render to texture");
+            C float scale_x = (float)resolution.target.texture.width / (float)screen_width;
+            C float scale_y = (float)resolution.target.texture.height / (float)screen_height;
 
-            C char *clue_str = crossword.vertical_mode ? selected_cell->vertical_entry->clue_str
-                                                       : selected_cell->horizontal_entry->clue_str;
-            DrawText(clue_str, 110, texture_height - 90, 20, BLACK);
+            Camera2D scaled = camera;
+            scaled.offset.x *= scale_x;
+            scaled.offset.y *= scale_y;
+            scaled.zoom *= scale_x;
 
+            BeginTextureMode(resolution.target);
+            ClearBackground(BLACK);
+            BeginMode2D(scaled);
+            board_renderer_draw(&board_renderer, &crossword, selected_cell);
+            EndMode2D();
             EndTextureMode();
+            PROFILE_END();
         }
 
-        // render the texture to the screen
+        // render to the screen
         {
+            PROFILE_BEGIN("draw");
             BeginDrawing();
-            C int W = GetScreenWidth();
-            C int H = GetScreenHeight();
+            ClearBackground(BLACK);
 
-            DrawTexturePro(
-                target.texture,
-                (Rectangle){0, 0, (float)target.texture.width, (float)-target.texture.height},
-                (Rectangle){0, 0, W, H}, (Vector2){0, 0}, 0, WHITE);
+            if (scaled)
+            {
+                C Texture2D t = resolution.target.texture;
+                DrawTexturePro(t, (Rectangle){0, 0, (float)t.width, (float)-t.height},
+                               (Rectangle){0, 0, (float)screen_width, (float)screen_height},
+                               (Vector2){0, 0}, 0, WHITE);
+            }
+            else
+            {
+                BeginMode2D(camera);
+                board_renderer_draw(&board_renderer, &crossword, selected_cell);
+                EndMode2D();
+            }
 
-            EndDrawing();
-        }
-    }
+            // render title and clue
+            if (title_width != screen_width)
+            {
+                block_centered_text_init(&title, (char *)"Crossword", 40, 20, WHITE, screen_width,
+                                         5, BLACK);
+                title_width = screen_width;
+            }
+            block_centered_text_render(&title);
 
-    adjust_cleanup();
-    UnloadRenderTexture(target);
-    CloseWindow();
+            DrawRectangle(100, screen_height - 100, screen_width - 200, 100, WHITE);
+            DrawRectangleLinesEx((Rectangle){99, screen_height - 101, screen_width - 198, 106}, 5,
+                                 BLACK);
 
-    return 0;
-}
+            C char *clue_str =
+                cw_cell_entry(&crossword, selected_cell, crossword.vertical_mode)->clue_str;
+            DrawText(clue_str, 110, screen_height - 90, 20, BLACK);
 
-void cw_validate_entry(Crossword *cw, Crossword_Entry *ce)
-{
-    i16 x = ce->start_x;
-    i16 y = ce->start_y;
-    bool valid = true;
+            profile_draw();
+            PROFILE_END();
 
-    while (cw->cells[y][x].correct_letter != 0)
-    {
-        C Cell *c = &cw->cells[y][x];
-        if (c->user_letter != c->correct_letter)
-        {
-            valid = false;
-            break;
+            C float work_time = (float)(GetTime() - frame_start);
+            PROFILE_BEGIN("end drawing");
+            EndDrawing();
+            PROFILE_END();
+            resolution_update(&resolution, GetFrameTime(), work_time);
+            replay_frame_end(&replay, work_time);
+            latency_frame_end(&latency);
+            soak_frame_end(&soak, &crossword, work_time);
         }
 
-        x += ce->dir_x;
-        y += ce->dir_y;
-    }
-
-    if (valid)
-    {
-        ce->complete = true;
-        x = ce->start_x;
-        y = ce->start_y;
-
-        while (cw->cells[y][x].correct_letter != 0)
+        if (replaying)
         {
-            cw->cells[y][x].locked = true;
-
-            x += ce->dir_x;
-            y += ce->dir_y;
+            spec_wait(speculator);
         }
-    }
-}
 
-bool cw_place_word(Crossword *cw, C Word *w, C bool vertical)
-{
-    assert(cw->num_entries <= CW_MAX_ENTRIES);
-
-    bool valid_placement_found = false;
-    i16 x, y;
-    if (cw->num_entries == 0)
-    {
-        // if there are no entries, there is no point looking for an interesection, and instead
-        // we'll just place the word in the center of the puzzle
-        x = CW_DIM / 2;
-        y = CW_DIM / 2;
-        valid_placement_found = true;
+        profile_frame();
+        // growing the board allocates, anything else shouldn't
+        mem_frame_end(g_assert_no_frame_allocations &&
+                      crossword.entries_version == frame_entries_version);
     }
-    else
-    {
-        C size_t offset = (size_t)GetRandomValue(0, (int)cw->num_entries - 1);
-        for (size_t _entry_index = 0; _entry_index < cw->num_entries; ++_entry_index)
-        {
-            C size_t entry_index = (_entry_index + offset) % cw->num_entries;
-            C Crossword_Entry *e = cw->entries + entry_index;
 
-            for (size_t cw_word_index = 0; cw_word_index < e->word_length; ++cw_word_index)
-            {
-                for (size_t new_word_index = 0; new_word_index < w->word_length; ++new_word_index)
-                {
-                }
-            }
-        }
+    replay_close(&replay);
+    latency_close(&latency);
+    C bool soak_passed = soak_close(&soak);
+    snapshot_publish(publisher, &crossword);
+    if (saving)
+    {
+        autosave_flush(autosave, selected_cell);
     }
+    autosave_destroy(autosave);
+    spec_destroy(speculator);
+    da_cleanup(growth_matches);
+    snapshot_publisher_destroy(publisher);
 
-    // TODO: handle case where we just need to place a word in empty cells and that's it. The
-    //       cw->num_entries code should probably use this function.
-
-    if (!valid_placement_found)
-        return true; // unable to place word
-
-    // once we have
-    Crossword_Entry *e = cw->entries + cw->num_entries;
-    e->word = w->word;
-    e->start_x = x;
-    e->start_y = y;
-    e->clue_str = w->clues[GetRandomValue(0, 2)];
-    e->word_length = w->word_length;
-
-    C i16 dir_x = !vertical;
-    C i16 dir_y = vertical;
-    e->dir_x = dir_x;
-    e->dir_y = dir_y;
-
-    Cell *c;
-    for (size_t i = 0; i < w->word_length; ++i)
+    profile_cleanup();
+    adjust_cleanup();
+    pack_close(&pack);
+    cw_cleanup(&crossword);
+    dict_cleanup(&dictionary);
+    board_renderer_cleanup(&board_renderer);
+    input_cleanup(&input);
+    if (resolution.target.id != 0)
     {
-        c = &cw->cells[y][x];
-        c->x = x;
-        c->y = y;
-        c->user_letter = ' ';
-        c->correct_letter = (char)toupper(w->word[i]);
-        c->locked = false;
-
-        if (vertical)
-        {
-            c->vertical_entry = e;
-        }
-        else
-        {
-            c->horizontal_entry = e;
-        }
-
-        x += dir_x;
-        y += dir_y;
+        UnloadRenderTexture(resolution.target);
     }
+    CloseWindow();
 
-    ++cw->num_entries;
-    return false;
+    return soak_passed ? 0 : 1;
 }
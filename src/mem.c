@@ -0,0 +1,213 @@
+#include "mem.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "thread.h"
+
+// see main.c
+#define C const
+
+// in front of every block, a multiple of 16 bytes so the block keeps malloc's alignment
+typedef struct
+{
+    u64 bytes;
+    u64 tag;
+} Mem_Header;
+
+static C char *mem_tag_names[MEM_TAGS] = {
+    "adjust",  "array", "dictionary", "fill",      "input",  "pack",
+    "profile", "save",  "snapshot",   "speculate", "thread",
+};
+
+// every counter is only ever added to, with the atomics in thread.h
+static Mem_Stats mem_tag_stats[MEM_TAGS];
+
+// for the frame assertion, which only looks at the main thread's
+static THREAD_LOCAL u64 mem_thread_allocations = 0;
+static THREAD_LOCAL int mem_thread_last_tag = -1;
+static THREAD_LOCAL u64 mem_thread_frame_start = 0;
+static u64 mem_frames = 0;
+static u64 mem_allocating_frames = 0;
+
+static void *mem_default_alloc(size_t bytes, void *context)
+{
+    (void)context;
+    return malloc(bytes);
+}
+
+static void *mem_default_realloc(void *ptr, size_t new_size, void *context)
+{
+    (void)context;
+    return realloc(ptr, new_size);
+}
+
+static void mem_default_free(void *ptr, void *context)
+{
+    (void)context;
+    free(ptr);
+}
+
+static Mem_Alloc_Func mem_alloc_func = mem_default_alloc;
+static Mem_Realloc_Func mem_realloc_func = mem_default_realloc;
+static Mem_Free_Func mem_free_func = mem_default_free;
+static void *mem_context = NULL;
+
+static void mem_count(C int tag, C u64 added_bytes, C u64 removed_bytes, C bool new_block)
+{
+    Mem_Stats *s = mem_tag_stats + tag;
+
+    C u64 bytes = atomic_add_u64(&s->bytes, added_bytes - removed_bytes);
+    if (bytes > atomic_load_u64(&s->peak_bytes))
+    {
+        atomic_store_u64(&s->peak_bytes, bytes);
+    }
+
+    if (new_block)
+    {
+        atomic_add_u64(&s->blocks, 1);
+    }
+
+    atomic_add_u64(&s->allocations, 1);
+    ++mem_thread_allocations;
+    mem_thread_last_tag = tag;
+}
+
+static void mem_out_of_memory(C int tag, C size_t bytes)
+{
+    fprintf(stderr, "Unable to allocate %zu bytes for the %s.\n", bytes, mem_tag_name(tag));
+    exit(1);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void mem_set_allocator(Mem_Alloc_Func alloc, Mem_Realloc_Func realloc, Mem_Free_Func free,
+                       void *context)
+{
+    mem_alloc_func = alloc;
+    mem_realloc_func = realloc;
+    mem_free_func = free;
+    mem_context = context;
+}
+
+void *mem_alloc(C int tag, C size_t bytes)
+{
+    assert(tag >= 0 && tag < MEM_TAGS);
+
+    Mem_Header *h = (Mem_Header *)mem_alloc_func(sizeof(Mem_Header) + bytes, mem_context);
+    if (!h)
+    {
+        mem_out_of_memory(tag, bytes);
+    }
+
+    memset(h + 1, 0, bytes);
+    h->bytes = bytes;
+    h->tag = (u64)tag;
+    mem_count(tag, bytes, 0, true);
+
+    return h + 1;
+}
+
+void *mem_realloc(C int tag, void *ptr, C size_t bytes)
+{
+    if (!ptr)
+        return mem_alloc(tag, bytes);
+
+    Mem_Header *h = (Mem_Header *)ptr - 1;
+    C int block_tag = (int)h->tag;
+    C u64 old_bytes = h->bytes;
+
+    h = (Mem_Header *)mem_realloc_func(h, sizeof(Mem_Header) + bytes, mem_context);
+    if (!h)
+    {
+        mem_out_of_memory(block_tag, bytes);
+    }
+
+    h->bytes = bytes;
+    mem_count(block_tag, bytes, old_bytes, false);
+
+    return h + 1;
+}
+
+void mem_free(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    Mem_Header *h = (Mem_Header *)ptr - 1;
+    Mem_Stats *s = mem_tag_stats + h->tag;
+    atomic_add_u64(&s->bytes, (u64)0 - h->bytes);
+    atomic_add_u64(&s->blocks, (u64)0 - 1);
+
+    mem_free_func(h, mem_context);
+}
+
+Mem_Stats mem_stats(C int tag)
+{
+    assert(tag >= 0 && tag < MEM_TAGS);
+
+    C Mem_Stats *s = mem_tag_stats + tag;
+    Mem_Stats result;
+    result.bytes = atomic_load_u64(&s->bytes);
+    result.peak_bytes = atomic_load_u64(&s->peak_bytes);
+    result.blocks = atomic_load_u64(&s->blocks);
+    result.allocations = atomic_load_u64(&s->allocations);
+    return result;
+}
+
+C char *mem_tag_name(C int tag)
+{
+    return tag >= 0 && tag < MEM_TAGS ? mem_tag_names[tag] : "unknown";
+}
+
+void mem_print_stats(void)
+{
+    printf("%-12s %12s %12s %8s %12s\n", "memory", "bytes", "peak bytes", "blocks",
+           "allocations");
+    for (int tag = 0; tag < MEM_TAGS; ++tag)
+    {
+        C Mem_Stats s = mem_stats(tag);
+        printf("%-12s %12llu %12llu %8llu %12llu\n", mem_tag_name(tag),
+               (unsigned long long)s.bytes, (unsigned long long)s.peak_bytes,
+               (unsigned long long)s.blocks, (unsigned long long)s.allocations);
+    }
+    printf("%llu of %llu frames allocated on the main thread\n",
+           (unsigned long long)mem_allocating_frames, (unsigned long long)mem_frames);
+}
+
+void mem_frame_begin(void)
+{
+    mem_thread_frame_start = mem_thread_allocations;
+}
+
+void mem_frame_end(C bool assert_none)
+{
+    C u64 allocations = mem_thread_allocations - mem_thread_frame_start;
+    ++mem_frames;
+    mem_allocating_frames += allocations > 0;
+
+    if (assert_none && allocations > 0)
+    {
+        fprintf(stderr, "%llu allocations this frame, the last for the %s.\n",
+                (unsigned long long)allocations, mem_tag_name(mem_thread_last_tag));
+        assert(allocations == 0);
+    }
+}
+
+void *mem_hook_alloc(size_t bytes, void *context)
+{
+    return mem_alloc((int)(intptr_t)context, bytes);
+}
+
+void *mem_hook_realloc(void *ptr, size_t new_size, void *context)
+{
+    return mem_realloc((int)(intptr_t)context, ptr, new_size);
+}
+
+void mem_hook_free(void *ptr, void *context)
+{
+    (void)context;
+    mem_free(ptr);
+}
@@ -0,0 +1,73 @@
+#ifndef _MEM_
+#define _MEM_
+
+#include <stddef.h>
+
+#include "common.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Every allocation the game makes (apart from raylib's) goes through here, tagged with the part of
+// the game it's for, so that it's known how much memory each part holds and how often each one
+// allocates. Blocks carry a small header with their tag and size, so freeing needs neither.
+//
+// Where the memory comes from can be swapped out the same way as adjust.h's (see
+// adjust_init_with_allocator), and mem_hook_* hand adjust.h's own allocations to this under a tag.
+//
+// Running out of memory is fatal, like it is everywhere else in the game.
+#define MEM_ADJUST 0 // first, as adjust.h at times passes a NULL context
+#define MEM_ARRAY 1  // dynamic_array.h
+#define MEM_DICTIONARY 2
+#define MEM_FILL 3
+#define MEM_INPUT 4
+#define MEM_PACK 5
+#define MEM_PROFILE 6
+#define MEM_SAVE 7
+#define MEM_SNAPSHOT 8
+#define MEM_SPECULATE 9
+#define MEM_THREAD 10
+#define MEM_TAGS 11
+
+typedef void *(*Mem_Alloc_Func)(size_t bytes, void *context);
+typedef void *(*Mem_Realloc_Func)(void *ptr, size_t new_size, void *context);
+typedef void (*Mem_Free_Func)(void *ptr, void *context);
+
+typedef struct
+{
+    u64 bytes;       // held right now
+    u64 peak_bytes;  // the most held at once, close enough when threads race on it
+    u64 blocks;      // held right now
+    u64 allocations; // every alloc and realloc so far
+} Mem_Stats;
+
+// Before anything is allocated. Defaults to malloc, realloc and free.
+extern void mem_set_allocator(Mem_Alloc_Func alloc, Mem_Realloc_Func realloc, Mem_Free_Func free,
+                              void *context);
+
+// Zeroed.
+extern void *mem_alloc(const int tag, const size_t bytes);
+
+// Keeps the tag `ptr` was allocated with, `tag` is only used when `ptr` is NULL. Memory past the
+// old size isn't zeroed.
+extern void *mem_realloc(const int tag, void *ptr, const size_t bytes);
+
+// NULL is fine.
+extern void mem_free(void *ptr);
+
+extern Mem_Stats mem_stats(const int tag);
+extern const char *mem_tag_name(const int tag);
+
+// Writes the stats of every tag to stdout.
+extern void mem_print_stats(void);
+
+// Main thread, at the start and end of every frame. With `assert_none` (a debug mode, to show
+// that a steady frame doesn't allocate) mem_frame_end asserts that the thread made no allocations
+// since mem_frame_begin, after printing how many there were and what the last one was for.
+extern void mem_frame_begin(void);
+extern void mem_frame_end(const bool assert_none);
+
+// For adjust_init_with_allocator, with the tag as the context, e.g., (void *)MEM_ADJUST.
+extern void *mem_hook_alloc(size_t bytes, void *context);
+extern void *mem_hook_realloc(void *ptr, size_t new_size, void *context);
+extern void mem_hook_free(void *ptr, void *context);
+
+#endif
@@ -0,0 +1,326 @@
+#include "profile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "mem.h"
+#include "raylib.h"
+#include "thread.h"
+
+#ifndef MODE_PRODUCTION
+
+// see main.c
+#define C const
+
+#define PROFILE_MAX_TRACKS 32
+#define PROFILE_MAX_DEPTH 32
+#define PROFILE_MAX_PHASES 32
+#define PROFILE_MAX_FRAME_EVENTS 256
+
+typedef struct
+{
+    C char *name;
+    double start;
+    double end;
+    u32 depth;
+} Profile_Event;
+
+typedef struct
+{
+    char name[32];
+    Mutex *lock;
+    Profile_Event *events; // PROFILE_RING_EVENTS of them
+    u64 pushed;            // the newest event is at (pushed - 1) % PROFILE_RING_EVENTS
+} Profile_Track;
+
+// the scopes a thread has open, which unlike its track are never shared
+typedef struct
+{
+    Profile_Track *track;
+    u32 depth;
+    C char *names[PROFILE_MAX_DEPTH];
+    double starts[PROFILE_MAX_DEPTH];
+} Profile_Thread;
+
+// the overlay's rolling average for one main thread scope
+typedef struct
+{
+    C char *name;
+    u32 depth;
+    double ms;
+    double frame_seconds;
+} Profile_Phase;
+
+static THREAD_LOCAL Profile_Thread profile_current;
+
+// tracks are only ever added, behind `profile_lock`
+static Mutex *profile_lock = NULL;
+static Profile_Track profile_tracks[PROFILE_MAX_TRACKS];
+static size_t profile_track_count = 0;
+static double profile_start_time = 0;
+
+// main thread only
+static bool profile_overlay = false;
+static u64 profile_frame_pushed = 0;
+static Profile_Phase profile_phases[PROFILE_MAX_PHASES];
+static size_t profile_phase_count = 0;
+
+// the track called `name`, or a new one named after its number for NULL
+static Profile_Track *profile_track(C char *name)
+{
+    mutex_lock(profile_lock);
+
+    Profile_Track *track = NULL;
+    for (size_t i = 0; i < profile_track_count && name && !track; ++i)
+    {
+        if (strcmp(profile_tracks[i].name, name) == 0)
+            track = profile_tracks + i;
+    }
+
+    if (!track && profile_track_count < PROFILE_MAX_TRACKS)
+    {
+        track = profile_tracks + profile_track_count;
+        if (name)
+        {
+            snprintf(track->name, sizeof(track->name), "%s", name);
+        }
+        else
+        {
+            snprintf(track->name, sizeof(track->name), "thread %zu", profile_track_count);
+        }
+
+        ++profile_track_count;
+        track->lock = mutex_create();
+        track->events = (Profile_Event *)mem_alloc(
+            MEM_PROFILE, PROFILE_RING_EVENTS * sizeof(Profile_Event));
+    }
+
+    mutex_unlock(profile_lock);
+    return track;
+}
+
+static void profile_export(void)
+{
+    FILE *file = fopen(PROFILE_EXPORT_PATH, "w");
+    if (!file)
+    {
+        fprintf(stderr, "Unable to write %s\n", PROFILE_EXPORT_PATH);
+        return;
+    }
+
+    mutex_lock(profile_lock);
+    C size_t track_count = profile_track_count;
+    mutex_unlock(profile_lock);
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (size_t t = 0; t < track_count; ++t)
+    {
+        Profile_Track *track = profile_tracks + t;
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,"
+                      "\"args\":{\"name\":\"%s\"}}",
+                t == 0 ? "" : ",\n", t, track->name);
+
+        mutex_lock(track->lock);
+        C u64 count = MIN(track->pushed, PROFILE_RING_EVENTS);
+        for (u64 i = track->pushed - count; i < track->pushed; ++i)
+        {
+            C Profile_Event *e = track->events + i % PROFILE_RING_EVENTS;
+            fprintf(file,
+                    ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,"
+                    "\"dur\":%.3f}",
+                    e->name, t, (e->start - profile_start_time) * 1e6, (e->end - e->start) * 1e6);
+        }
+        mutex_unlock(track->lock);
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    printf("Wrote %s\n", PROFILE_EXPORT_PATH);
+}
+
+static int profile_compare_starts(C void *a, C void *b)
+{
+    C double x = ((C Profile_Event *)a)->start;
+    C double y = ((C Profile_Event *)b)->start;
+    return (x > y) - (x < y);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void profile_init(void)
+{
+    profile_lock = mutex_create();
+    profile_start_time = GetTime();
+    profile_thread("main");
+}
+
+void profile_cleanup(void)
+{
+    for (size_t i = 0; i < profile_track_count; ++i)
+    {
+        mutex_destroy(profile_tracks[i].lock);
+        mem_free(profile_tracks[i].events);
+    }
+
+    profile_track_count = 0;
+    mutex_destroy(profile_lock);
+    profile_lock = NULL;
+    profile_current.track = NULL;
+}
+
+void profile_thread(C char *name)
+{
+    if (profile_lock)
+    {
+        profile_current.track = profile_track(name);
+    }
+}
+
+void profile_begin(C char *name)
+{
+    if (!profile_lock)
+        return;
+
+    if (!profile_current.track)
+    {
+        profile_current.track = profile_track(NULL);
+    }
+
+    // too deep to record, but still counted so that the ends match up
+    Profile_Thread *thread = &profile_current;
+    if (thread->depth < PROFILE_MAX_DEPTH)
+    {
+        thread->names[thread->depth] = name;
+        thread->starts[thread->depth] = GetTime();
+    }
+    ++thread->depth;
+}
+
+void profile_end(void)
+{
+    Profile_Thread *thread = &profile_current;
+    if (!profile_lock || thread->depth == 0)
+        return;
+
+    --thread->depth;
+    if (thread->depth >= PROFILE_MAX_DEPTH || !thread->track)
+        return;
+
+    Profile_Event e;
+    e.name = thread->names[thread->depth];
+    e.start = thread->starts[thread->depth];
+    e.end = GetTime();
+    e.depth = thread->depth;
+
+    Profile_Track *track = thread->track;
+    mutex_lock(track->lock);
+    track->events[track->pushed % PROFILE_RING_EVENTS] = e;
+    ++track->pushed;
+    mutex_unlock(track->lock);
+}
+
+void profile_frame(void)
+{
+    if (!profile_lock)
+        return;
+
+    if (IsKeyPressed(KEY_F3))
+    {
+        profile_overlay = !profile_overlay;
+    }
+
+    if (IsKeyPressed(KEY_F4))
+    {
+        profile_export();
+    }
+
+    // this frame's scopes on the main thread (the first track), in the order they started so
+    // that new phases are listed under the one they're in
+    Profile_Event events[PROFILE_MAX_FRAME_EVENTS];
+    size_t count = 0;
+
+    Profile_Track *track = profile_tracks;
+    mutex_lock(track->lock);
+    C u64 oldest = track->pushed - MIN(track->pushed, PROFILE_RING_EVENTS);
+    for (u64 i = MAX(profile_frame_pushed, oldest); i < track->pushed; ++i)
+    {
+        if (count < PROFILE_MAX_FRAME_EVENTS)
+        {
+            events[count++] = track->events[i % PROFILE_RING_EVENTS];
+        }
+    }
+    profile_frame_pushed = track->pushed;
+    mutex_unlock(track->lock);
+
+    qsort(events, count, sizeof(Profile_Event), profile_compare_starts);
+    for (size_t i = 0; i < count; ++i)
+    {
+        C Profile_Event *e = events + i;
+
+        Profile_Phase *phase = NULL;
+        for (size_t p = 0; p < profile_phase_count && !phase; ++p)
+        {
+            if (profile_phases[p].name == e->name && profile_phases[p].depth == e->depth)
+                phase = profile_phases + p;
+        }
+
+        if (!phase && profile_phase_count < PROFILE_MAX_PHASES)
+        {
+            phase = profile_phases + profile_phase_count++;
+            phase->name = e->name;
+            phase->depth = e->depth;
+        }
+
+        if (phase)
+        {
+            phase->frame_seconds += e->end - e->start;
+        }
+    }
+
+    for (size_t p = 0; p < profile_phase_count; ++p)
+    {
+        Profile_Phase *phase = profile_phases + p;
+        phase->ms += (phase->frame_seconds * 1000 - phase->ms) * 0.1;
+        phase->frame_seconds = 0;
+    }
+}
+
+void profile_draw(void)
+{
+    if (!profile_overlay)
+        return;
+
+    // the phases, then how much memory each part of the game holds
+    int memory_lines = 0;
+    for (int tag = 0; tag < MEM_TAGS; ++tag)
+    {
+        memory_lines += mem_stats(tag).bytes > 0;
+    }
+
+    C int font_size = 20;
+    C int line_height = font_size + 4;
+    C int lines = (int)profile_phase_count + 1 + memory_lines;
+    DrawRectangle(0, 0, 320, 10 + line_height * lines, Fade(BLACK, 0.75f));
+
+    for (size_t p = 0; p < profile_phase_count; ++p)
+    {
+        C Profile_Phase *phase = profile_phases + p;
+        C int y = 5 + line_height * (int)p;
+        DrawText(phase->name, 5 + 15 * (int)phase->depth, y, font_size, WHITE);
+        DrawText(TextFormat("%6.2f ms", phase->ms), 220, y, font_size, WHITE);
+    }
+
+    int line = (int)profile_phase_count + 1;
+    for (int tag = 0; tag < MEM_TAGS; ++tag)
+    {
+        C Mem_Stats stats = mem_stats(tag);
+        if (stats.bytes == 0)
+            continue;
+
+        C int y = 5 + line_height * line++;
+        DrawText(mem_tag_name(tag), 5, y, font_size, LIGHTGRAY);
+        DrawText(TextFormat("%6.0f KB", (double)stats.bytes / 1024), 220, y, font_size, LIGHTGRAY);
+    }
+}
+#endif
@@ -0,0 +1,68 @@
+#ifndef _PROFILE_
+#define _PROFILE_
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// A small timing profiler for the frame and the threads working next to it. Scopes are timed
+// into a ring buffer per thread, which keeps the last PROFILE_RING_EVENTS of them:
+//
+//     PROFILE_SCOPE("keyboard input")
+//     {
+//         ...
+//     }
+//
+// Don't break, goto or return out of a scope, or it's never closed. Where a block doesn't fit,
+// PROFILE_BEGIN and PROFILE_END do the same.
+//
+// In game, F3 shows a rolling average of every main thread scope per frame, along with the memory
+// each part of the game holds (see mem.h), and F4 writes every ring to profile.json in Chrome's
+// trace event format (chrome://tracing or ui.perfetto.dev), with each thread on its own track.
+// Threads are told apart by name (see profile_thread) rather than by OS thread, so workers that are
+// started for every job share one track.
+//
+// Like adjust.h, all of it compiles to nothing with MODE_PRODUCTION.
+#ifdef MODE_PRODUCTION
+#define PROFILE_SCOPE(name)
+#define PROFILE_BEGIN(name) ((void)0)
+#define PROFILE_END() ((void)0)
+
+#define profile_init() ((void)0)
+#define profile_cleanup() ((void)0)
+#define profile_thread(name) ((void)0)
+#define profile_frame() ((void)0)
+#define profile_draw() ((void)0)
+
+#else
+#define PROFILE_RING_EVENTS 16384
+#define PROFILE_EXPORT_PATH "profile.json"
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name)                                                                       \
+    for (int PROFILE_CONCAT(profile_scope_, __LINE__) = (profile_begin(name), 0);                 \
+         !PROFILE_CONCAT(profile_scope_, __LINE__);                                               \
+         PROFILE_CONCAT(profile_scope_, __LINE__) = (profile_end(), 1))
+#define PROFILE_BEGIN(name) profile_begin(name)
+#define PROFILE_END() profile_end()
+
+// Main thread, before anything is timed.
+extern void profile_init(void);
+// Main thread, once every other thread that was timed is done.
+extern void profile_cleanup(void);
+
+// Names the track the calling thread's scopes go to, "main" for the thread that called
+// profile_init and "thread <n>" for any other that isn't named. `name` has to outlive the
+// profiler (a string literal).
+extern void profile_thread(const char *name);
+
+// Main thread, once a frame after EndDrawing. Handles the keys and updates the overlay.
+extern void profile_frame(void);
+
+// Main thread, inside BeginDrawing.
+extern void profile_draw(void);
+
+// Use the macros. `name` has to outlive the profiler (a string literal).
+extern void profile_begin(const char *name);
+extern void profile_end(void);
+#endif
+
+#endif
@@ -0,0 +1,216 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "puzzle_pack.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "mem.h"
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#define PACK_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// see main.c
+#define C const
+
+static bool pack_read_file(Puzzle_Pack *pack, C char *path)
+{
+#if defined(PACK_MMAP)
+    C int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    pack->data = data;
+    pack->size = (size_t)st.st_size;
+    pack->mapped = true;
+    return true;
+#else
+    // no mmap on this platform, so read the whole thing in. Packs are small enough that this is
+    // still a single read at startup.
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return false;
+
+    fseek(f, 0, SEEK_END);
+    C long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size <= 0)
+    {
+        fclose(f);
+        return false;
+    }
+
+    void *data = mem_alloc(MEM_PACK, (size_t)size);
+    if (fread(data, 1, (size_t)size, f) != (size_t)size)
+    {
+        mem_free(data);
+        fclose(f);
+        return false;
+    }
+
+    fclose(f);
+    pack->data = data;
+    pack->size = (size_t)size;
+    pack->mapped = false;
+    return true;
+#endif
+}
+
+// `first` has `count + 1` offsets into an array of `total`, which have to go up and stay in it
+static bool pack_offsets_valid(C u32 *first, C u32 count, C u32 total)
+{
+    for (u32 i = 0; i < count; ++i)
+    {
+        if (first[i] > first[i + 1])
+            return false;
+    }
+
+    return first[count] <= total;
+}
+
+bool pack_open(Puzzle_Pack *pack, C char *path)
+{
+    memset(pack, 0, sizeof(Puzzle_Pack));
+    if (!pack_read_file(pack, path))
+        return false;
+
+    C Pack_Header *h = (C Pack_Header *)pack->data;
+    if (pack->size < sizeof(Pack_Header) || memcmp(h->magic, PACK_MAGIC, 4) != 0 ||
+        h->version != PACK_VERSION)
+    {
+        fprintf(stderr, "%s is not a puzzle pack (or is an old version).\n", path);
+        pack_close(pack);
+        return false;
+    }
+
+    if (h->words_count != words_count || h->words_hash != cw_words_hash())
+    {
+        fprintf(stderr, "%s was built against a different dictionary, ignoring it.\n", path);
+        pack_close(pack);
+        return false;
+    }
+
+    // in u64, as the counts are read from the file and anything near UINT32_MAX would wrap
+    C u64 expected = sizeof(Pack_Header) + sizeof(u32) * ((u64)h->band_count + 1) +
+                     sizeof(u32) * ((u64)h->puzzle_count + 1) + sizeof(u32) * (u64)h->entry_count +
+                     sizeof(u16) * (u64)h->entry_count;
+    if ((u64)pack->size < expected)
+    {
+        fprintf(stderr, "%s is truncated.\n", path);
+        pack_close(pack);
+        return false;
+    }
+
+    C u8 *bytes = (C u8 *)pack->data + sizeof(Pack_Header);
+    pack->header = h;
+    pack->band_first_puzzle = (C u32 *)bytes;
+    bytes += sizeof(u32) * ((size_t)h->band_count + 1);
+    pack->puzzle_first_entry = (C u32 *)bytes;
+    bytes += sizeof(u32) * ((size_t)h->puzzle_count + 1);
+    pack->entry_word = (C u32 *)bytes;
+    bytes += sizeof(u32) * (size_t)h->entry_count;
+    pack->entry_placement = (C u16 *)bytes;
+
+    // checked once here so that loading a puzzle can index them as they are
+    if (!pack_offsets_valid(pack->band_first_puzzle, h->band_count, h->puzzle_count) ||
+        !pack_offsets_valid(pack->puzzle_first_entry, h->puzzle_count, h->entry_count))
+    {
+        fprintf(stderr, "%s is corrupt.\n", path);
+        pack_close(pack);
+        return false;
+    }
+
+    return true;
+}
+
+void pack_close(Puzzle_Pack *pack)
+{
+    if (pack->data)
+    {
+#if defined(PACK_MMAP)
+        munmap(pack->data, pack->size);
+#else
+        mem_free(pack->data);
+#endif
+    }
+
+    memset(pack, 0, sizeof(Puzzle_Pack));
+}
+
+bool pack_write(C char *path, C u32 band_count, C u32 *band_first_puzzle, C u32 puzzle_count,
+                C u32 *puzzle_first_entry, C u32 entry_count, C u32 *entry_word,
+                C u16 *entry_placement)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+
+    Pack_Header h = {0};
+    memcpy(h.magic, PACK_MAGIC, 4);
+    h.version = PACK_VERSION;
+    h.words_count = (u32)words_count;
+    h.words_hash = cw_words_hash();
+    h.band_count = band_count;
+    h.puzzle_count = puzzle_count;
+    h.entry_count = entry_count;
+
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    ok = ok && fwrite(band_first_puzzle, sizeof(u32), band_count + 1, f) == band_count + 1;
+    ok = ok && fwrite(puzzle_first_entry, sizeof(u32), puzzle_count + 1, f) == puzzle_count + 1;
+    ok = ok && fwrite(entry_word, sizeof(u32), entry_count, f) == entry_count;
+    ok = ok && fwrite(entry_placement, sizeof(u16), entry_count, f) == entry_count;
+
+    return fclose(f) == 0 && ok;
+}
+
+size_t pack_band_count(C Puzzle_Pack *pack)
+{
+    return pack->header ? pack->header->band_count : 0;
+}
+
+size_t pack_band_puzzle_count(C Puzzle_Pack *pack, C size_t band)
+{
+    if (band >= pack_band_count(pack))
+        return 0;
+
+    return pack->band_first_puzzle[band + 1] - pack->band_first_puzzle[band];
+}
+
+bool pack_load_puzzle(C Puzzle_Pack *pack, C size_t band, C size_t index, Crossword *cw)
+{
+    C size_t count = pack_band_puzzle_count(pack, band);
+    if (count == 0)
+        return false;
+
+    C size_t puzzle = pack->band_first_puzzle[band] + index % count;
+    C u32 first = pack->puzzle_first_entry[puzzle];
+    C u32 last = pack->puzzle_first_entry[puzzle + 1];
+
+    cw_clear(cw);
+    for (u32 i = first; i < last; ++i)
+    {
+        if (!cw_add_packed_entry(cw, pack->entry_word[i], pack->entry_placement[i]))
+            return false;
+    }
+
+    return cw_num_entries(cw) > 0;
+}
@@ -0,0 +1,63 @@
+#ifndef _PUZZLE_PACK_
+#define _PUZZLE_PACK_
+
+#include <stddef.h>
+
+#include "common.h"
+#include "crossword.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Precomputed puzzles written by tools/pack_puzzles.c. The file is little endian and laid out so
+// that it can be mapped and used in place:
+//
+//   Pack_Header
+//   u32 band_first_puzzle[band_count + 1]
+//   u32 puzzle_first_entry[puzzle_count + 1]
+//   u32 entry_word[entry_count]         index into `words`
+//   u16 entry_placement[entry_count]    see cw_pack_placement
+//
+// Puzzles are grouped by difficulty band, easiest band first.
+#define PACK_MAGIC "CWPK"
+#define PACK_VERSION 1
+
+typedef struct
+{
+    char magic[4];
+    u32 version;
+    u32 words_count;
+    u32 words_hash;
+    u32 band_count;
+    u32 puzzle_count;
+    u32 entry_count;
+    u32 reserved;
+} Pack_Header;
+
+typedef struct
+{
+    void *data;
+    size_t size;
+    bool mapped;
+
+    const Pack_Header *header;
+    const u32 *band_first_puzzle;
+    const u32 *puzzle_first_entry;
+    const u32 *entry_word;
+    const u16 *entry_placement;
+} Puzzle_Pack;
+
+// Returns false if the file is missing, malformed, or was built against a different dictionary.
+extern bool pack_open(Puzzle_Pack *pack, const char *path);
+extern void pack_close(Puzzle_Pack *pack);
+
+extern bool pack_write(const char *path, const u32 band_count, const u32 *band_first_puzzle,
+                       const u32 puzzle_count, const u32 *puzzle_first_entry,
+                       const u32 entry_count, const u32 *entry_word, const u16 *entry_placement);
+
+extern size_t pack_band_count(const Puzzle_Pack *pack);
+extern size_t pack_band_puzzle_count(const Puzzle_Pack *pack, const size_t band);
+
+// Clears the crossword and fills it with the puzzle. Returns false if the band is empty.
+extern bool pack_load_puzzle(const Puzzle_Pack *pack, const size_t band, const size_t index,
+                             Crossword *cw);
+
+#endif
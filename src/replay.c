@@ -0,0 +1,217 @@
+#include "replay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dynamic_array.h"
+#include "mem.h"
+
+// see main.c
+#define C const
+
+// AutomationEventType is internal to raylib (rcore.c), these match it
+#define REPLAY_KEY_DOWN 2
+#define REPLAY_MOUSE_BUTTON_DOWN 6
+#define REPLAY_MOUSE_WHEEL_MOTION 8
+
+// whether a played event is the player doing something, rather than holding a key down or moving
+// the mouse around
+static bool replay_is_input(C AutomationEvent *e)
+{
+    switch (e->type)
+    {
+    case REPLAY_KEY_DOWN:
+        return IsKeyPressed(e->params[0]);
+    case REPLAY_MOUSE_BUTTON_DOWN:
+        return IsMouseButtonPressed(e->params[0]);
+    case REPLAY_MOUSE_WHEEL_MOTION:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static int replay_compare_floats(C void *a, C void *b)
+{
+    C float x = *(C float *)a;
+    C float y = *(C float *)b;
+    return (x > y) - (x < y);
+}
+
+// sorts `samples`
+static void replay_print_stats(C char *name, float *samples)
+{
+    C size_t n = da_length(samples);
+    if (n == 0)
+    {
+        printf("%-14s no samples\n", name);
+        return;
+    }
+
+    qsort(samples, n, sizeof(float), replay_compare_floats);
+
+    double total = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        total += samples[i];
+    }
+
+    printf("%-14s mean %7.3f  p50 %7.3f  p95 %7.3f  p99 %7.3f  max %7.3f ms\n", name,
+           1000 * total / (double)n, 1000 * samples[n / 2], 1000 * samples[n * 95 / 100],
+           1000 * samples[n * 99 / 100], 1000 * samples[n - 1]);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool replay_open(Replay *r, C int mode, C char *path, C u64 seed)
+{
+    memset(r, 0, sizeof(Replay));
+    r->mode = mode;
+    r->path = path;
+    r->seed = seed;
+
+    if (mode == REPLAY_RECORD)
+    {
+        r->events = LoadAutomationEventList(NULL);
+    }
+    else if (mode == REPLAY_PLAY)
+    {
+        FILE *file = fopen(path, "r");
+        if (!file)
+        {
+            fprintf(stderr, "Unable to open %s\n", path);
+            return false;
+        }
+
+        bool seeded = false;
+        char line[256];
+        while (!seeded && fgets(line, sizeof(line), file))
+        {
+            unsigned long long value;
+            if (sscanf(line, "s %llu", &value) == 1)
+            {
+                r->seed = (u64)value;
+                seeded = true;
+            }
+        }
+        fclose(file);
+
+        if (!seeded)
+        {
+            fprintf(stderr, "%s is not a recorded session.\n", path);
+            return false;
+        }
+
+        // sized for the whole session up front, so that it doesn't allocate while it plays (see
+        // mem_frame_end)
+        r->events = LoadAutomationEventList(path);
+        C size_t frames =
+            r->events.count > 0 ? r->events.events[r->events.count - 1].frame + 1 : 1;
+        r->frame_times = (float *)da_init(sizeof(float), frames);
+        r->work_times = (float *)da_init(sizeof(float), frames);
+        r->latencies = (float *)da_init(sizeof(float), frames);
+    }
+
+    return true;
+}
+
+void replay_begin(Replay *r)
+{
+    if (r->mode == REPLAY_OFF)
+        return;
+
+    // raylib logs every event it records or plays
+    SetTraceLogLevel(LOG_WARNING);
+
+    if (r->mode == REPLAY_RECORD)
+    {
+        SetAutomationEventList(&r->events);
+        SetAutomationEventBaseFrame(0);
+        StartAutomationEventRecording();
+    }
+}
+
+void replay_frame_begin(Replay *r)
+{
+    if (r->mode != REPLAY_PLAY)
+        return;
+
+    r->input_time = 0;
+    while (r->next_event < r->events.count && r->events.events[r->next_event].frame <= r->frame)
+    {
+        C AutomationEvent *e = r->events.events + r->next_event;
+        PlayAutomationEvent(*e);
+        if (r->input_time == 0 && replay_is_input(e))
+        {
+            r->input_time = GetTime();
+        }
+
+        ++r->next_event;
+    }
+}
+
+void replay_frame_end(Replay *r, C float work_time)
+{
+    if (r->mode == REPLAY_RECORD && !r->full && r->events.count == r->events.capacity)
+    {
+        // raylib stops recording here, so the session ends early when it's played back
+        r->full = true;
+        fprintf(stderr, "Recorded %u events, the most a session holds. The rest isn't recorded.\n",
+                r->events.count);
+    }
+    else if (r->mode == REPLAY_PLAY)
+    {
+        *(float *)da_append((void **)&r->frame_times) = GetFrameTime();
+        *(float *)da_append((void **)&r->work_times) = work_time;
+        if (r->input_time != 0)
+        {
+            *(float *)da_append((void **)&r->latencies) = (float)(GetTime() - r->input_time);
+        }
+    }
+
+    ++r->frame;
+}
+
+bool replay_done(C Replay *r)
+{
+    return r->mode == REPLAY_PLAY && r->next_event == r->events.count;
+}
+
+void replay_close(Replay *r)
+{
+    if (r->mode == REPLAY_RECORD)
+    {
+        StopAutomationEventRecording();
+
+        FILE *file = NULL;
+        if (ExportAutomationEventList(r->events, r->path))
+        {
+            file = fopen(r->path, "a");
+        }
+
+        if (file)
+        {
+            fprintf(file, "s %llu\n", (unsigned long long)r->seed);
+            fclose(file);
+        }
+        else
+        {
+            fprintf(stderr, "Unable to write %s\n", r->path);
+        }
+
+        UnloadAutomationEventList(r->events);
+    }
+    else if (r->mode == REPLAY_PLAY)
+    {
+        printf("%s: %u frames, %zu with input\n", r->path, r->frame, da_length(r->latencies));
+        replay_print_stats("frame time", r->frame_times);
+        replay_print_stats("work time", r->work_times);
+        replay_print_stats("input latency", r->latencies);
+        mem_print_stats();
+
+        da_cleanup(r->frame_times);
+        da_cleanup(r->work_times);
+        da_cleanup(r->latencies);
+        UnloadAutomationEventList(r->events);
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef _REPLAY_
+#define _REPLAY_
+
+#include "common.h"
+#include "raylib.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Recording play sessions and playing them back, on top of raylib's automation events. A session
+// is raylib's event file plus an "s <seed>" line with the seed the game was started with (raylib's
+// loader skips lines it doesn't know).
+//
+// The game only moves forward by frames, never by wall clock, once the things that do depend on
+// it are out of the way: sessions start from a new puzzle rather than the save, nothing is
+// autosaved, and speculation is waited on every frame (see spec_wait). Events are played back by
+// the frame they were recorded on, so a replay goes through the same boards as the session did,
+// however fast it runs.
+//
+// A replay reports how long frames took and how long it took from played input to the end of the
+// frame that showed it.
+#define REPLAY_OFF 0
+#define REPLAY_RECORD 1
+#define REPLAY_PLAY 2
+
+typedef struct
+{
+    int mode;
+    const char *path;
+    u64 seed;
+
+    AutomationEventList events;
+    unsigned int frame; // counted from replay_begin
+    unsigned int next_event;
+    bool full;
+
+    double input_time; // when this frame's input was played, 0 if it had none
+    float *frame_times;
+    float *work_times;
+    float *latencies;
+} Replay;
+
+// Before the window is opened. Playing loads the session at `path` (and its seed), recording uses
+// `seed`. Returns false if the session can't be loaded.
+extern bool replay_open(Replay *r, const int mode, const char *path, const u64 seed);
+
+// Right before the first frame.
+extern void replay_begin(Replay *r);
+
+// Start of every frame, before any input is read. Plays this frame's events.
+extern void replay_frame_begin(Replay *r);
+
+// After EndDrawing. `work_time` is the part of the frame spent on the frame itself.
+extern void replay_frame_end(Replay *r, const float work_time);
+
+// Whether every event has been played.
+extern bool replay_done(const Replay *r);
+
+// After the last frame. Writes the session when recording and prints the stats when playing.
+extern void replay_close(Replay *r);
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef _RNG_
+#define _RNG_
+
+#include "common.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Small, seedable random number generator (splitmix64). raylib's
+// GetRandomValue() works off of one global state, which means it can't be used
+// from worker threads or the offline tools, and it can't be replayed.
+///////////////////////////////////////////////////////////////////////////////
+typedef struct
+{
+    u64 state;
+} Rng;
+
+static inline void rng_seed(Rng *rng, const u64 seed)
+{
+    rng->state = seed;
+}
+
+static inline u64 rng_next(Rng *rng)
+{
+    u64 z = (rng->state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// inclusive on both ends, same as GetRandomValue()
+static inline i32 rng_range(Rng *rng, const i32 min, const i32 max)
+{
+    assert(min <= max);
+    return min + (i32)(rng_next(rng) % (u64)((i64)max - (i64)min + 1));
+}
+
+static inline f32 rng_float(Rng *rng)
+{
+    return (f32)(rng_next(rng) >> 40) / (f32)(1u << 24);
+}
+
+#endif
@@ -0,0 +1,414 @@
+#include "save.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// raylib builds sdefl/sinfl for its compression API, so only the declarations are needed here
+#include "external/sdefl.h"
+#include "external/sinfl.h"
+
+#include "mem.h"
+#include "profile.h"
+#include "thread.h"
+
+// see main.c
+#define C const
+
+#define SAVE_COMPRESSION_LEVEL 8
+#define SAVE_LETTER_BITS 5
+
+// num_entries, selected_x, selected_y, vertical_mode, rng_state
+#define SAVE_FIXED_SIZE (4 + 2 + 2 + 1 + 8)
+#define SAVE_ENTRY_SIZE (4 + 2)
+#define SAVE_LETTERS_MAX_SIZE ((CW_DIM * CW_DIM * SAVE_LETTER_BITS + 7) / 8)
+
+static inline size_t save_max_raw_size(C size_t num_entries)
+{
+    return SAVE_FIXED_SIZE + SAVE_ENTRY_SIZE * num_entries + SAVE_LETTERS_MAX_SIZE;
+}
+
+typedef struct
+{
+    char magic[4];
+    u32 version;
+    u32 words_hash;
+    u32 raw_size;
+    u32 compressed_size;
+} Save_Header;
+
+struct Autosave
+{
+    char *path;
+    Mutex *lock;
+    Thread *thread;
+    bool busy;
+    Snapshot_Publisher *publisher;
+
+    // only touched by the thread doing the save
+    Board_Snapshot *snapshot;
+    i16 selected_x, selected_y;
+    struct sdefl *deflate;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Encoding
+static void save_put(u8 *buffer, size_t *size, C void *src, C size_t bytes)
+{
+    memcpy(buffer + *size, src, bytes);
+    *size += bytes;
+}
+
+static size_t save_encode(C Board_Snapshot *s, C i16 selected_x, C i16 selected_y, u8 *buffer)
+{
+    size_t size = 0;
+    C u32 num_entries = (u32)snapshot_num_entries(s);
+    C u8 vertical_mode = s->vertical_mode;
+    save_put(buffer, &size, &num_entries, 4);
+    save_put(buffer, &size, &selected_x, 2);
+    save_put(buffer, &size, &selected_y, 2);
+    save_put(buffer, &size, &vertical_mode, 1);
+    save_put(buffer, &size, &s->rng.state, 8);
+
+    for (u32 i = 0; i < num_entries; ++i)
+    {
+        C Crossword_Entry *e = snapshot_entry(s, (u16)i);
+        C u16 placement = cw_pack_placement(e->start_x, e->start_y, e->dir_y == 1, e->clue_index);
+        save_put(buffer, &size, &e->word_index, 4);
+        save_put(buffer, &size, &placement, 2);
+    }
+
+    // only cells that are part of an entry have a letter, and the loader walks the rebuilt board
+    // in the same order
+    u32 bits = 0;
+    u32 bit_count = 0;
+    for (i16 y = 0; y < CW_DIM; ++y)
+    {
+        for (i16 x = 0; x < CW_DIM; ++x)
+        {
+            C Cell *c = snapshot_cell(s, x, y);
+            if (c->correct_letter == 0)
+                continue;
+
+            C char letter = c->user_letter;
+            C u32 code = (letter >= 'A' && letter <= 'Z') ? (u32)(letter - 'A' + 1) : 0;
+            bits |= code << bit_count;
+            bit_count += SAVE_LETTER_BITS;
+
+            while (bit_count >= 8)
+            {
+                C u8 byte = (u8)(bits & 0xFF);
+                save_put(buffer, &size, &byte, 1);
+                bits >>= 8;
+                bit_count -= 8;
+            }
+        }
+    }
+
+    if (bit_count > 0)
+    {
+        C u8 byte = (u8)(bits & 0xFF);
+        save_put(buffer, &size, &byte, 1);
+    }
+
+    return size;
+}
+
+static bool save_write_with(C char *path, C Board_Snapshot *s, C i16 selected_x,
+                            C i16 selected_y, struct sdefl *deflate)
+{
+    u8 *raw = (u8 *)mem_alloc(MEM_SAVE, save_max_raw_size(snapshot_num_entries(s)));
+    C size_t raw_size = save_encode(s, selected_x, selected_y, raw);
+
+    u8 *compressed = (u8 *)mem_alloc(MEM_SAVE, (size_t)sdefl_bound((int)raw_size));
+    C int compressed_size =
+        sdeflate(deflate, compressed, raw, (int)raw_size, SAVE_COMPRESSION_LEVEL);
+
+    Save_Header h = {0};
+    memcpy(h.magic, SAVE_MAGIC, 4);
+    h.version = SAVE_VERSION;
+    h.words_hash = cw_words_hash();
+    h.raw_size = (u32)raw_size;
+    h.compressed_size = (u32)compressed_size;
+
+    // write next to the real file and then swap it in, so a crash mid-write can't lose the save
+    char tmp_path[512];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    bool ok = false;
+    FILE *f = fopen(tmp_path, "wb");
+    if (f)
+    {
+        ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+             fwrite(compressed, 1, (size_t)compressed_size, f) == (size_t)compressed_size;
+        ok = fclose(f) == 0 && ok;
+    }
+
+    if (ok)
+    {
+#ifdef _WIN32
+        remove(path);
+#endif
+        ok = rename(tmp_path, path) == 0;
+    }
+
+    mem_free(compressed);
+    mem_free(raw);
+    return ok;
+}
+
+bool save_write(C char *path, C Board_Snapshot *s, C i16 selected_x, C i16 selected_y)
+{
+    struct sdefl *deflate = (struct sdefl *)mem_alloc(MEM_SAVE, sizeof(struct sdefl));
+    C bool ok = save_write_with(path, s, selected_x, selected_y, deflate);
+    mem_free(deflate);
+    return ok;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Decoding
+typedef struct
+{
+    C u8 *data;
+    size_t size;
+    size_t at;
+    bool ok;
+} Save_Reader;
+
+static void save_get(Save_Reader *r, void *dst, C size_t bytes)
+{
+    if (!r->ok || r->at + bytes > r->size)
+    {
+        r->ok = false;
+        memset(dst, 0, bytes);
+        return;
+    }
+
+    memcpy(dst, r->data + r->at, bytes);
+    r->at += bytes;
+}
+
+// bytes from the position in `f` to its end, leaving the position where it was
+static u64 save_bytes_left(FILE *f)
+{
+    C long at = ftell(f);
+    if (at < 0 || fseek(f, 0, SEEK_END) != 0)
+        return 0;
+
+    C long end = ftell(f);
+    fseek(f, at, SEEK_SET);
+    return end > at ? (u64)(end - at) : 0;
+}
+
+bool save_load(C char *path, Crossword *cw, i16 *selected_x, i16 *selected_y)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return false;
+
+    Save_Header h;
+    if (fread(&h, sizeof(h), 1, f) != 1 || memcmp(h.magic, SAVE_MAGIC, 4) != 0 ||
+        h.version != SAVE_VERSION || h.raw_size > save_max_raw_size(CW_MAX_ENTRIES) ||
+        h.words_hash != cw_words_hash())
+    {
+        fprintf(stderr, "%s is not a save for this version of the game, ignoring it.\n", path);
+        fclose(f);
+        return false;
+    }
+
+    // the compressed size is read from the file too, so it's only used once it's no bigger than
+    // the rest of the file and than anything save_write could have made from raw_size
+    if (h.compressed_size > (u32)sdefl_bound((int)h.raw_size) ||
+        (u64)h.compressed_size > save_bytes_left(f))
+    {
+        fprintf(stderr, "%s is corrupt, ignoring it.\n", path);
+        fclose(f);
+        return false;
+    }
+
+    u8 *compressed = (u8 *)mem_alloc(MEM_SAVE, (size_t)h.compressed_size + 1);
+    C bool read_ok = fread(compressed, 1, h.compressed_size, f) == h.compressed_size;
+    fclose(f);
+
+    u8 *raw = (u8 *)mem_alloc(MEM_SAVE, (size_t)h.raw_size + 1);
+    C int raw_size =
+        read_ok ? sinflate(raw, (int)h.raw_size, compressed, (int)h.compressed_size) : -1;
+    mem_free(compressed);
+
+    if (raw_size != (int)h.raw_size)
+    {
+        fprintf(stderr, "%s is corrupt, ignoring it.\n", path);
+        mem_free(raw);
+        return false;
+    }
+
+    Save_Reader r = {raw, (size_t)raw_size, 0, true};
+    u32 num_entries;
+    u8 vertical_mode;
+    u64 rng_state;
+    save_get(&r, &num_entries, 4);
+    save_get(&r, selected_x, 2);
+    save_get(&r, selected_y, 2);
+    save_get(&r, &vertical_mode, 1);
+    save_get(&r, &rng_state, 8);
+
+    cw_clear(cw);
+    cw->rng.state = rng_state;
+    cw->vertical_mode = vertical_mode != 0;
+
+    for (u32 i = 0; r.ok && i < num_entries; ++i)
+    {
+        u32 word_index;
+        u16 placement;
+        save_get(&r, &word_index, 4);
+        save_get(&r, &placement, 2);
+        r.ok = r.ok && cw_add_packed_entry(cw, word_index, placement);
+    }
+
+    u32 bits = 0;
+    u32 bit_count = 0;
+    for (size_t y = 0; r.ok && y < CW_DIM; ++y)
+    {
+        for (size_t x = 0; r.ok && x < CW_DIM; ++x)
+        {
+            Cell *c = &cw->cells[y][x];
+            if (c->correct_letter == 0)
+                continue;
+
+            while (bit_count < SAVE_LETTER_BITS)
+            {
+                u8 byte;
+                save_get(&r, &byte, 1);
+                bits |= (u32)byte << bit_count;
+                bit_count += 8;
+            }
+
+            C u32 code = bits & ((1u << SAVE_LETTER_BITS) - 1);
+            bits >>= SAVE_LETTER_BITS;
+            bit_count -= SAVE_LETTER_BITS;
+            cw_set_user_letter(cw, c, (code >= 1 && code <= 26) ? (char)('A' + code - 1) : ' ');
+        }
+    }
+
+    mem_free(raw);
+
+    if (!r.ok || cw_num_entries(cw) == 0 || *selected_x < 0 || *selected_y < 0 ||
+        *selected_x >= CW_DIM || *selected_y >= CW_DIM ||
+        cw->cells[*selected_y][*selected_x].correct_letter == 0)
+    {
+        fprintf(stderr, "%s is corrupt, ignoring it.\n", path);
+        cw_clear(cw);
+        return false;
+    }
+
+    // the direction is read from the file as well, so face the way the selected cell has an entry,
+    // like clicking on it does
+    C Cell *selected = &cw->cells[*selected_y][*selected_x];
+    if (!cw_cell_entry(cw, selected, cw->vertical_mode))
+    {
+        cw->vertical_mode = !cw->vertical_mode;
+    }
+
+    // locks aren't stored, completing the entries again puts them back
+    for (size_t i = 0; i < cw_num_entries(cw); ++i)
+    {
+        cw_validate_entry(cw, cw->entries + i);
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Autosave
+static void autosave_write(Autosave *as)
+{
+    if (!save_write_with(as->path, as->snapshot, as->selected_x, as->selected_y, as->deflate))
+    {
+        fprintf(stderr, "Unable to write %s\n", as->path);
+    }
+
+    snapshot_release(as->publisher, as->snapshot);
+    as->snapshot = NULL;
+}
+
+static void autosave_worker(void *arg)
+{
+    Autosave *as = (Autosave *)arg;
+    profile_thread("autosave");
+    PROFILE_BEGIN("autosave");
+    autosave_write(as);
+    PROFILE_END();
+
+    mutex_lock(as->lock);
+    as->busy = false;
+    mutex_unlock(as->lock);
+}
+
+Autosave *autosave_create(C char *path, Snapshot_Publisher *publisher)
+{
+    Autosave *as = (Autosave *)mem_alloc(MEM_SAVE, sizeof(Autosave));
+    C size_t length = strlen(path);
+    as->path = (char *)mem_alloc(MEM_SAVE, length + 1);
+    memcpy(as->path, path, length + 1);
+    as->lock = mutex_create();
+    as->publisher = publisher;
+    as->deflate = (struct sdefl *)mem_alloc(MEM_SAVE, sizeof(struct sdefl));
+    return as;
+}
+
+bool autosave_request(Autosave *as, C Cell *selected)
+{
+    mutex_lock(as->lock);
+    C bool busy = as->busy;
+    mutex_unlock(as->lock);
+
+    if (busy)
+        return false;
+
+    // the previous save already finished, so this join doesn't block
+    if (as->thread)
+    {
+        thread_join(as->thread);
+        as->thread = NULL;
+    }
+
+    as->snapshot = snapshot_acquire(as->publisher);
+    if (!as->snapshot)
+        return false;
+
+    as->selected_x = selected->x;
+    as->selected_y = selected->y;
+    as->busy = true;
+    as->thread = thread_create(autosave_worker, as);
+    return true;
+}
+
+void autosave_flush(Autosave *as, C Cell *selected)
+{
+    if (as->thread)
+    {
+        thread_join(as->thread);
+        as->thread = NULL;
+        as->busy = false;
+    }
+
+    as->snapshot = snapshot_acquire(as->publisher);
+    if (!as->snapshot)
+        return;
+
+    as->selected_x = selected->x;
+    as->selected_y = selected->y;
+    autosave_write(as);
+}
+
+void autosave_destroy(Autosave *as)
+{
+    if (as->thread)
+    {
+        thread_join(as->thread);
+    }
+
+    mutex_destroy(as->lock);
+    mem_free(as->deflate);
+    mem_free(as->path);
+    mem_free(as);
+}
@@ -0,0 +1,37 @@
+#ifndef _SAVE_
+#define _SAVE_
+
+#include "common.h"
+#include "crossword.h"
+#include "snapshot.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Save files hold the board as entry placements (word index + packed placement) and the player's
+// letters as 5 bit codes, compressed with sdefl. Nothing in the file is a pointer, so the board is
+// rebuilt from the entries on load.
+//
+// Saves are written from board snapshots (see snapshot.h), so the live crossword is never touched
+// while encoding, compressing, and writing the file on a background thread through Autosave.
+#define SAVE_MAGIC "CWSV"
+#define SAVE_VERSION 1
+
+typedef struct Autosave Autosave;
+
+// Encodes, compresses, and writes the snapshot. This is slow-ish, so use Autosave from the game.
+extern bool save_write(const char *path, const Board_Snapshot *s, i16 selected_x, i16 selected_y);
+
+// Rebuilds the crossword from a save file. Returns false if there is no (valid) save.
+extern bool save_load(const char *path, Crossword *cw, i16 *selected_x, i16 *selected_y);
+
+// Saves whatever the publisher last published, so publish before requesting a save.
+extern Autosave *autosave_create(const char *path, Snapshot_Publisher *publisher);
+
+// Writes the latest snapshot on a background thread. Returns false, without doing anything, if the
+// previous save hasn't finished yet.
+extern bool autosave_request(Autosave *as, const Cell *selected);
+
+// Waits for any save in flight and then writes the latest snapshot on the calling thread.
+extern void autosave_flush(Autosave *as, const Cell *selected);
+extern void autosave_destroy(Autosave *as);
+
+#endif
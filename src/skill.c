@@ -0,0 +1,133 @@
+#include "skill.h"
+
+#include <math.h>
+
+// see main.c
+#define C const
+
+// how many logits the middle half of the dictionary spans, which sets the scale
+#define SKILL_MIDDLE_LOGITS 4.0
+
+// how far below the ability the words scored SKILL_TARGET_SCORE on are
+static double skill_target_offset(C Skill *s)
+{
+    return s->scale * log(SKILL_TARGET_SCORE / (1.0 - SKILL_TARGET_SCORE));
+}
+
+// the first word at least as surprising as `surprisal`
+static size_t skill_find(C double surprisal)
+{
+    size_t lo = 0, hi = words_count;
+    while (lo < hi)
+    {
+        C size_t mid = lo + (hi - lo) / 2;
+        if (words[mid].surprisal < surprisal)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+// Moves the band to be centered on words[center], as close as it can while keeping its width.
+static void skill_center(Skill *s, C size_t center)
+{
+    C size_t width = s->band_end - s->band_start;
+    s->band_start = center > width / 2 ? center - width / 2 : 0;
+    s->band_start = MIN(s->band_start, words_count - width);
+    s->band_end = s->band_start + width;
+
+    // past either end of the dictionary the target can't go, so the band stays put there
+    C size_t stay = (size_t)(width * SKILL_HYSTERESIS);
+    s->stay_min = words[center > stay ? center - stay : 0].surprisal;
+    s->stay_max = words[MIN(center + stay, words_count - 1)].surprisal;
+}
+
+// Starts a new attempt when the player moves on to another entry. The time since the last key
+// typed elsewhere goes to the new entry, as that's when they started on it.
+static void skill_attempt(Skill *s, C u16 entry, C double time)
+{
+    if (entry != s->entry)
+    {
+        s->entry = entry;
+        s->entry_start = MAX(s->last_key, time - SKILL_MAX_PAUSE);
+        s->letters = 0;
+        s->wrong = 0;
+        s->backspaces = 0;
+    }
+
+    s->last_key = time;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void skill_init(Skill *s, C size_t band_start, C size_t band_end, C double time)
+{
+    assert(band_start < band_end && band_end <= words_count);
+
+    s->finished = 0;
+    s->entry = CW_NO_ENTRY;
+    s->entry_start = time;
+    s->last_key = time;
+    s->letters = 0;
+    s->wrong = 0;
+    s->backspaces = 0;
+
+    C double q1 = words[words_count / 4].surprisal;
+    C double q3 = words[words_count * 3 / 4].surprisal;
+    s->scale = MAX(q3 - q1, 1e-6) / SKILL_MIDDLE_LOGITS;
+
+    C size_t center = band_start + (band_end - band_start) / 2;
+    s->ability = words[center].surprisal + skill_target_offset(s);
+    s->band_start = band_start;
+    s->band_end = band_end;
+    skill_center(s, center);
+}
+
+void skill_letter(Skill *s, C u16 entry, C bool right, C double time)
+{
+    skill_attempt(s, entry, time);
+    if (right)
+        ++s->letters;
+    else
+        ++s->wrong;
+}
+
+void skill_backspace(Skill *s, C u16 entry, C double time)
+{
+    skill_attempt(s, entry, time);
+    ++s->backspaces;
+}
+
+bool skill_finish(Skill *s, C Word *word, C double time)
+{
+    C double letters = (double)MAX(s->letters, 1);
+    C double pace = (time - s->entry_start) / letters;
+    C double speed = (SKILL_SLOW_SECONDS - pace) / (SKILL_SLOW_SECONDS - SKILL_FAST_SECONDS);
+    C double errors = s->wrong + SKILL_BACKSPACE_COST * s->backspaces;
+    C double accuracy = 1.0 - errors / (double)word->word_length;
+    C double score = SKILL_SPEED_WEIGHT * MIN(MAX(speed, 0.0), 1.0) +
+                     (1.0 - SKILL_SPEED_WEIGHT) * MAX(accuracy, 0.0);
+
+    C double expected = 1.0 / (1.0 + exp((word->surprisal - s->ability) / s->scale));
+    C double settled = (double)s->finished / SKILL_SETTLE_ENTRIES;
+    C double step = MAX(SKILL_MIN_STEP, SKILL_FIRST_STEP / (1.0 + settled));
+
+    // kept to where there are words to give the player, so it can't run off past either end
+    C double offset = skill_target_offset(s);
+    s->ability += step * s->scale * (score - expected);
+    s->ability = MAX(s->ability, words[0].surprisal + offset);
+    s->ability = MIN(s->ability, words[words_count - 1].surprisal + offset);
+    ++s->finished;
+
+    // whatever is typed next is a new attempt, starting now
+    s->entry = CW_NO_ENTRY;
+    s->last_key = time;
+
+    C double target = s->ability - offset;
+    if (target >= s->stay_min && target <= s->stay_max)
+        return false;
+
+    skill_center(s, skill_find(target));
+    return true;
+}
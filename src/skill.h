@@ -0,0 +1,81 @@
+#ifndef _SKILL_
+#define _SKILL_
+
+#include <stddef.h>
+
+#include "common.h"
+#include "crossword.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Estimates how good the player is while they play, to pick the difficulty band the board grows
+// from. It's a Rasch (one parameter IRT) model, updated the way Elo ratings are: a word's
+// difficulty is its surprisal, the player has an ability on the same scale, and the score the
+// player is expected to get on a word is
+//
+//   logistic((ability - surprisal) / scale)
+//
+// Every finished entry is scored from 0 to 1 by how fast its letters were typed and how many
+// wrong letters and backspaces it took, and the ability moves towards whatever would have
+// predicted that score. The steps start large so that a new player is placed quickly, and shrink
+// as entries are finished so that one slow entry can't swing it.
+//
+// The band stays as wide as the one the player started on, centered on the words the player is
+// expected to score SKILL_TARGET_SCORE on. It only moves once that center has drifted more than
+// SKILL_HYSTERESIS of a band away, so that the words don't flip back and forth between two bands.
+//
+// Keys and finished entries are O(1). Moving the band is a binary search of `words`.
+#define SKILL_TARGET_SCORE 0.7
+#define SKILL_HYSTERESIS 0.25
+
+// Per letter, the pace that scores full marks for speed and the one that scores none.
+#define SKILL_FAST_SECONDS 1.0
+#define SKILL_SLOW_SECONDS 6.0
+
+// How much of the score is speed; the rest is accuracy. A wrong letter costs a whole letter's
+// worth of accuracy and a backspace half of one.
+#define SKILL_SPEED_WEIGHT 0.5
+#define SKILL_BACKSPACE_COST 0.5
+
+// Time spent away from the keyboard before the first key of an entry isn't counted past this.
+#define SKILL_MAX_PAUSE 10.0
+
+// The step, in logits, for the first entry and the smallest it gets, and how many entries it
+// takes to halve it.
+#define SKILL_FIRST_STEP 1.0
+#define SKILL_MIN_STEP 0.15
+#define SKILL_SETTLE_ENTRIES 8
+
+typedef struct
+{
+    double ability; // in surprisal
+    double scale;   // surprisal per logit, from how spread out the dictionary is
+    u32 finished;   // entries scored so far
+
+    // the entry being typed into
+    u16 entry;
+    double entry_start;
+    double last_key;
+    u32 letters; // typed right
+    u32 wrong;
+    u32 backspaces;
+
+    // words[band_start, band_end), moved once the target surprisal leaves [stay_min, stay_max]
+    size_t band_start, band_end;
+    double stay_min, stay_max;
+} Skill;
+
+// Starts the player off on words[band_start, band_end). `time` is in seconds from any fixed
+// point, the same for every call.
+extern void skill_init(Skill *s, const size_t band_start, const size_t band_end,
+                       const double time);
+
+// A letter typed into `entry`, and whether it was the right one.
+extern void skill_letter(Skill *s, const u16 entry, const bool right, const double time);
+
+// A backspace in `entry`.
+extern void skill_backspace(Skill *s, const u16 entry, const double time);
+
+// The entry last typed into was just finished with `word`. Returns true if the band moved.
+extern bool skill_finish(Skill *s, const Word *word, const double time);
+
+#endif
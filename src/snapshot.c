@@ -0,0 +1,274 @@
+#include "snapshot.h"
+
+#include <string.h>
+
+#include "mem.h"
+#include "thread.h"
+
+// see main.c
+#define C const
+
+struct Snapshot_Publisher
+{
+    Mutex *lock;
+    Board_Snapshot *current;
+
+    // what `current` was built from
+    u32 tile_versions[CW_TILES][CW_TILES];
+    u32 entries_version;
+
+    // released memory is recycled so that publishing doesn't hit malloc once things warm up
+    Board_Tile *free_tiles;
+    Board_Entries *free_entries;
+    Board_Snapshot *free_snapshots;
+};
+
+// Readers (the renderer, speculation and autosave) hold on to at most one snapshot each, so with
+// the current one this many changes can be in flight before a tile or snapshot has to be allocated
+#define SNAPSHOT_SPARES 4
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Everything below that touches reference counts or free lists expects the lock to be held
+static Board_Tile *snapshot_new_tile(Snapshot_Publisher *p)
+{
+    Board_Tile *t = p->free_tiles;
+    if (t)
+        p->free_tiles = t->next_free;
+    else
+        t = (Board_Tile *)mem_alloc(MEM_SNAPSHOT, sizeof(Board_Tile));
+
+    t->refs = 1;
+    t->next_free = NULL;
+    return t;
+}
+
+static Board_Entries *snapshot_new_entries(Snapshot_Publisher *p)
+{
+    Board_Entries *e = p->free_entries;
+    if (e)
+    {
+        p->free_entries = e->next_free;
+    }
+    else
+    {
+        e = (Board_Entries *)mem_alloc(MEM_SNAPSHOT, sizeof(Board_Entries));
+        e->items = (Crossword_Entry *)da_init(sizeof(Crossword_Entry), 16);
+    }
+
+    e->refs = 1;
+    e->next_free = NULL;
+    return e;
+}
+
+static Board_Snapshot *snapshot_new(Snapshot_Publisher *p)
+{
+    Board_Snapshot *s = p->free_snapshots;
+    if (s)
+        p->free_snapshots = s->next_free;
+    else
+        s = (Board_Snapshot *)mem_alloc(MEM_SNAPSHOT, sizeof(Board_Snapshot));
+
+    s->refs = 1;
+    s->next_free = NULL;
+    return s;
+}
+
+static void snapshot_release_locked(Snapshot_Publisher *p, Board_Snapshot *s)
+{
+    assert(s->refs > 0);
+    if (--s->refs > 0)
+        return;
+
+    for (size_t ty = 0; ty < CW_TILES; ++ty)
+    {
+        for (size_t tx = 0; tx < CW_TILES; ++tx)
+        {
+            Board_Tile *t = s->tiles[ty][tx];
+            if (--t->refs == 0)
+            {
+                t->next_free = p->free_tiles;
+                p->free_tiles = t;
+            }
+        }
+    }
+
+    if (--s->entries->refs == 0)
+    {
+        s->entries->next_free = p->free_entries;
+        p->free_entries = s->entries;
+    }
+
+    s->next_free = p->free_snapshots;
+    p->free_snapshots = s;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+Snapshot_Publisher *snapshot_publisher_create(void)
+{
+    Snapshot_Publisher *p =
+        (Snapshot_Publisher *)mem_alloc(MEM_SNAPSHOT, sizeof(Snapshot_Publisher));
+    p->lock = mutex_create();
+    return p;
+}
+
+void snapshot_publisher_destroy(Snapshot_Publisher *p)
+{
+    // every acquired snapshot must have been released by now
+    if (p->current)
+    {
+        snapshot_release_locked(p, p->current);
+    }
+
+    while (p->free_tiles)
+    {
+        Board_Tile *t = p->free_tiles;
+        p->free_tiles = t->next_free;
+        mem_free(t);
+    }
+
+    while (p->free_entries)
+    {
+        Board_Entries *e = p->free_entries;
+        p->free_entries = e->next_free;
+        da_cleanup(e->items);
+        mem_free(e);
+    }
+
+    while (p->free_snapshots)
+    {
+        Board_Snapshot *s = p->free_snapshots;
+        p->free_snapshots = s->next_free;
+        mem_free(s);
+    }
+
+    mutex_destroy(p->lock);
+    mem_free(p);
+}
+
+bool snapshot_publish(Snapshot_Publisher *p, C Crossword *cw)
+{
+    // only the main thread replaces `current`, so it can be read here without the lock
+    Board_Snapshot *prev = p->current;
+    if (prev && prev->vertical_mode == cw->vertical_mode && prev->rng.state == cw->rng.state &&
+        p->entries_version == cw->entries_version &&
+        memcmp(p->tile_versions, cw->tile_versions, sizeof(p->tile_versions)) == 0)
+    {
+        return false;
+    }
+
+    mutex_lock(p->lock);
+
+    Board_Snapshot *s = snapshot_new(p);
+    s->version = prev ? prev->version + 1 : 1;
+    s->entries_version = cw->entries_version;
+    s->vertical_mode = cw->vertical_mode;
+    s->rng = cw->rng;
+
+    for (size_t ty = 0; ty < CW_TILES; ++ty)
+    {
+        for (size_t tx = 0; tx < CW_TILES; ++tx)
+        {
+            if (prev && p->tile_versions[ty][tx] == cw->tile_versions[ty][tx])
+            {
+                s->tiles[ty][tx] = prev->tiles[ty][tx];
+                ++s->tiles[ty][tx]->refs;
+                continue;
+            }
+
+            Board_Tile *t = snapshot_new_tile(p);
+            C size_t x0 = tx * CW_TILE_DIM;
+            C size_t y0 = ty * CW_TILE_DIM;
+            C size_t w = MIN(CW_TILE_DIM, CW_DIM - x0);
+            C size_t h = MIN(CW_TILE_DIM, CW_DIM - y0);
+            for (size_t y = 0; y < h; ++y)
+            {
+                memcpy(t->cells[y], &cw->cells[y0 + y][x0], w * sizeof(Cell));
+            }
+
+            s->tiles[ty][tx] = t;
+            p->tile_versions[ty][tx] = cw->tile_versions[ty][tx];
+        }
+    }
+
+    if (prev && p->entries_version == cw->entries_version)
+    {
+        s->entries = prev->entries;
+        ++s->entries->refs;
+    }
+    else
+    {
+        s->entries = snapshot_new_entries(p);
+        da_copy((void **)&s->entries->items, cw->entries);
+        p->entries_version = cw->entries_version;
+    }
+
+    p->current = s;
+    if (prev)
+    {
+        snapshot_release_locked(p, prev);
+    }
+    else
+    {
+        // warmed up from the start, so that not even the first few letters typed allocate
+        for (size_t i = 0; i < SNAPSHOT_SPARES; ++i)
+        {
+            Board_Tile *t = (Board_Tile *)mem_alloc(MEM_SNAPSHOT, sizeof(Board_Tile));
+            t->next_free = p->free_tiles;
+            p->free_tiles = t;
+
+            Board_Snapshot *spare =
+                (Board_Snapshot *)mem_alloc(MEM_SNAPSHOT, sizeof(Board_Snapshot));
+            spare->next_free = p->free_snapshots;
+            p->free_snapshots = spare;
+        }
+    }
+
+    mutex_unlock(p->lock);
+    return true;
+}
+
+Board_Snapshot *snapshot_acquire(Snapshot_Publisher *p)
+{
+    mutex_lock(p->lock);
+    Board_Snapshot *s = p->current;
+    if (s)
+    {
+        ++s->refs;
+    }
+    mutex_unlock(p->lock);
+
+    return s;
+}
+
+void snapshot_release(Snapshot_Publisher *p, Board_Snapshot *s)
+{
+    mutex_lock(p->lock);
+    snapshot_release_locked(p, s);
+    mutex_unlock(p->lock);
+}
+
+void snapshot_restore(C Board_Snapshot *s, Crossword *cw)
+{
+    cw_clear(cw);
+    for (size_t i = 0; i < snapshot_num_entries(s); ++i)
+    {
+        C Crossword_Entry *e = snapshot_entry(s, (u16)i);
+        Crossword_Entry *copy =
+            cw_add_entry(cw, e->word_index, e->start_x, e->start_y, e->dir_y == 1, e->clue_index);
+        copy->complete = e->complete;
+    }
+
+    for (i16 y = 0; y < CW_DIM; ++y)
+    {
+        for (i16 x = 0; x < CW_DIM; ++x)
+        {
+            C Cell *c = snapshot_cell(s, x, y);
+            cw->cells[y][x].user_letter = c->user_letter;
+            cw->cells[y][x].locked = c->locked;
+        }
+    }
+
+    cw->vertical_mode = s->vertical_mode;
+    cw->rng = s->rng;
+    cw->entries_version = s->entries_version;
+}
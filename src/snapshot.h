@@ -0,0 +1,75 @@
+#ifndef _SNAPSHOT_
+#define _SNAPSHOT_
+
+#include "common.h"
+#include "crossword.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Read-only, versioned copies of the board for anything that runs off the main thread.
+//
+// The main thread calls snapshot_publish() once per frame. Only the tiles whose version changed
+// since the last publish are copied; every other tile (and the entries, if they didn't change) is
+// shared with the previous snapshot. Workers snapshot_acquire() the latest snapshot, read it for
+// as long as they like without any locking, and snapshot_release() it when done. The publisher's
+// lock is only held to swap the current snapshot and to adjust reference counts.
+typedef struct Board_Tile Board_Tile;
+typedef struct Board_Entries Board_Entries;
+typedef struct Snapshot_Publisher Snapshot_Publisher;
+
+struct Board_Tile
+{
+    u32 refs;
+    Board_Tile *next_free;
+    Cell cells[CW_TILE_DIM][CW_TILE_DIM];
+};
+
+struct Board_Entries
+{
+    u32 refs;
+    Board_Entries *next_free;
+    Crossword_Entry *items; // dynamic array
+};
+
+typedef struct Board_Snapshot
+{
+    u32 refs;
+    struct Board_Snapshot *next_free;
+
+    u64 version;
+    u32 entries_version; // the crossword's entries_version when this was taken
+    Board_Tile *tiles[CW_TILES][CW_TILES];
+    Board_Entries *entries;
+    bool vertical_mode;
+    Rng rng;
+} Board_Snapshot;
+
+extern Snapshot_Publisher *snapshot_publisher_create(void);
+extern void snapshot_publisher_destroy(Snapshot_Publisher *p);
+
+// Main thread only. Returns true if a new snapshot was published (false when nothing changed).
+extern bool snapshot_publish(Snapshot_Publisher *p, const Crossword *cw);
+
+// Returns NULL if nothing was published yet. Every acquire needs a matching release.
+extern Board_Snapshot *snapshot_acquire(Snapshot_Publisher *p);
+extern void snapshot_release(Snapshot_Publisher *p, Board_Snapshot *s);
+
+// Rebuilds a private, fully working crossword (bitboards and all) from a snapshot, e.g. so a
+// worker can try out changes to the board.
+extern void snapshot_restore(const Board_Snapshot *s, Crossword *cw);
+
+static inline const Cell *snapshot_cell(const Board_Snapshot *s, const i16 x, const i16 y)
+{
+    return &s->tiles[y / CW_TILE_DIM][x / CW_TILE_DIM]->cells[y % CW_TILE_DIM][x % CW_TILE_DIM];
+}
+
+static inline size_t snapshot_num_entries(const Board_Snapshot *s)
+{
+    return da_length(s->entries->items);
+}
+
+static inline const Crossword_Entry *snapshot_entry(const Board_Snapshot *s, const u16 index)
+{
+    return index == CW_NO_ENTRY ? NULL : s->entries->items + index;
+}
+
+#endif
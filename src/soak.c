@@ -0,0 +1,328 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "soak.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "dynamic_array.h"
+#include "mem.h"
+#include "raylib.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+// see main.c
+#define C const
+
+// how much more the later half of the samples can have than the earlier half, as a fraction and
+// on top of that
+#define SOAK_MEMORY_TOLERANCE 0.05
+#define SOAK_MEMORY_SLACK (1024.0 * 1024.0)
+#define SOAK_TIME_TOLERANCE 0.25
+#define SOAK_TIME_SLACK 0.0005
+
+// after the warm up, fewer than this can't show a trend
+#define SOAK_MIN_SAMPLES 4
+
+#define SOAK_UNREACHED 0xFFFF
+
+// what the OS holds in memory for the game, 0 where that isn't known
+static u64 soak_resident_bytes(void)
+{
+#if defined(__linux__)
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (!file)
+        return 0;
+
+    unsigned long long size = 0, resident = 0;
+    C int read = fscanf(file, "%llu %llu", &size, &resident);
+    fclose(file);
+    return read == 2 ? (u64)resident * (u64)sysconf(_SC_PAGESIZE) : 0;
+#else
+    return 0;
+#endif
+}
+
+static u64 soak_counted_bytes(void)
+{
+    u64 bytes = 0;
+    for (int tag = 0; tag < MEM_TAGS; ++tag)
+    {
+        bytes += mem_stats(tag).bytes;
+    }
+
+    return bytes;
+}
+
+// how many arrow key presses it takes to get from `selected` to every letter cell, and the way
+// there
+static void soak_walk(Soak *s, C Crossword *cw, C Cell *selected)
+{
+    static C i16 steps[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+    memset(s->distance, 0xFF, sizeof(s->distance));
+    s->distance[selected->y][selected->x] = 0;
+    s->queue[0] = (u16)(selected->y * CW_DIM + selected->x);
+
+    size_t head = 0, tail = 1;
+    while (head < tail)
+    {
+        C u16 cell = s->queue[head++];
+        C i16 x = (i16)(cell % CW_DIM);
+        C i16 y = (i16)(cell / CW_DIM);
+
+        for (size_t i = 0; i < 4; ++i)
+        {
+            C i16 nx = x + steps[i][0];
+            C i16 ny = y + steps[i][1];
+            if (nx < 0 || ny < 0 || nx >= CW_DIM || ny >= CW_DIM ||
+                cw->cells[ny][nx].correct_letter == 0 || s->distance[ny][nx] != SOAK_UNREACHED)
+                continue;
+
+            s->distance[ny][nx] = (u16)(s->distance[y][x] + 1);
+            s->from[ny][nx] = cell;
+            s->queue[tail++] = (u16)(ny * CW_DIM + nx);
+        }
+    }
+}
+
+// The cell of `e` to type into next: the first wrong one, or when none are, the first that isn't
+// locked (as typing the right letter again is what finishes an entry). NULL when every cell is
+// locked by the entries crossing it, which leaves nothing to type.
+static C Cell *soak_goal(C Crossword *cw, C Crossword_Entry *e)
+{
+    C Cell *open = NULL;
+    for (size_t i = 0; i < e->word_length; ++i)
+    {
+        C Cell *c = &cw->cells[e->start_y + e->dir_y * (i16)i][e->start_x + e->dir_x * (i16)i];
+        if (c->locked)
+            continue;
+
+        if (c->user_letter != c->correct_letter)
+            return c;
+
+        if (!open)
+        {
+            open = c;
+        }
+    }
+
+    return open;
+}
+
+// the arrow key that goes from `from` to the cell next to it at `x`, `y`
+static int soak_arrow(C Cell *from, C i16 x, C i16 y)
+{
+    if (x != from->x)
+        return x > from->x ? KEY_RIGHT : KEY_LEFT;
+
+    return y > from->y ? KEY_DOWN : KEY_UP;
+}
+
+// `count` samples summed into one
+static Soak_Sample soak_sum(C Soak_Sample *samples, C size_t count)
+{
+    Soak_Sample sum = {0};
+    for (size_t i = 0; i < count; ++i)
+    {
+        sum.resident_bytes += samples[i].resident_bytes;
+        sum.counted_bytes += samples[i].counted_bytes;
+        sum.work_time += samples[i].work_time;
+        sum.frames += samples[i].frames;
+        sum.grow_time += samples[i].grow_time;
+        sum.grows += samples[i].grows;
+    }
+
+    return sum;
+}
+
+// whether `late` stayed within the tolerance of `early`, printed in `unit`s
+static bool soak_check(C char *name, C double early, C double late, C double tolerance,
+                       C double slack, C double unit, C char *unit_name)
+{
+    C bool passed = late <= early * (1 + tolerance) + slack;
+    printf("%-10s %10.3f -> %10.3f %s  %s\n", name, early / unit, late / unit, unit_name,
+           passed ? "ok" : "WENT UP");
+    return passed;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void soak_init(Soak *s, C double seconds, C u64 seed)
+{
+    memset(s, 0, sizeof(Soak));
+    s->seconds = seconds;
+    s->target = CW_NO_ENTRY;
+    if (seconds > 0)
+    {
+        rng_seed(&s->rng, seed);
+        s->start_time = GetTime();
+
+        // all of them up front, so that sampling doesn't allocate (see mem_frame_end)
+        C size_t samples = (size_t)(seconds / SOAK_SAMPLE_SECONDS) + 1;
+        s->samples = (Soak_Sample *)da_init(sizeof(Soak_Sample), samples);
+    }
+}
+
+bool soak_close(Soak *s)
+{
+    if (s->seconds <= 0)
+        return true;
+
+    // the first puzzle is the warm up
+    C size_t n = da_length(s->samples);
+    size_t first = 0;
+    while (first < n && s->samples[first].puzzles == 0)
+    {
+        ++first;
+    }
+
+    bool passed = true;
+    C size_t count = n - first;
+    if (count < SOAK_MIN_SAMPLES)
+    {
+        printf("soak: %zu samples after the first puzzle, too few to tell a trend\n", count);
+    }
+    else
+    {
+        C size_t early_count = count / 2;
+        C size_t late_count = count - early_count;
+        C Soak_Sample early = soak_sum(s->samples + first, early_count);
+        C Soak_Sample late = soak_sum(s->samples + first + early_count, late_count);
+        C double mb = 1024.0 * 1024.0;
+
+        passed &= soak_check("resident", (double)early.resident_bytes / (double)early_count,
+                             (double)late.resident_bytes / (double)late_count,
+                             SOAK_MEMORY_TOLERANCE, SOAK_MEMORY_SLACK, mb, "MB");
+        passed &= soak_check("counted", (double)early.counted_bytes / (double)early_count,
+                             (double)late.counted_bytes / (double)late_count,
+                             SOAK_MEMORY_TOLERANCE, SOAK_MEMORY_SLACK, mb, "MB");
+        passed &= soak_check("work time", early.work_time / MAX(early.frames, 1),
+                             late.work_time / MAX(late.frames, 1), SOAK_TIME_TOLERANCE,
+                             SOAK_TIME_SLACK, 0.001, "ms");
+        if (early.grows > 0 && late.grows > 0)
+        {
+            passed &= soak_check("growth", early.grow_time / early.grows,
+                                 late.grow_time / late.grows, SOAK_TIME_TOLERANCE,
+                                 SOAK_TIME_SLACK, 0.001, "ms");
+        }
+    }
+
+    printf("soak %s after %u puzzles\n", passed ? "passed" : "FAILED", s->puzzles);
+    da_cleanup(s->samples);
+    return passed;
+}
+
+int soak_key(Soak *s, C Crossword *cw, C Cell *selected)
+{
+    if (s->seconds <= 0)
+        return 0;
+
+    soak_walk(s, cw, selected);
+
+    // keep at the entry until it's finished, then go to the nearest one left
+    C Crossword_Entry *e = cw_entry(cw, s->target);
+    C Cell *goal = e && !e->complete ? soak_goal(cw, e) : NULL;
+    if (!goal || s->distance[goal->y][goal->x] == SOAK_UNREACHED)
+    {
+        s->target = CW_NO_ENTRY;
+        u16 nearest = SOAK_UNREACHED;
+        for (size_t i = 0; i < cw_num_entries(cw); ++i)
+        {
+            C Cell *c = cw->entries[i].complete ? NULL : soak_goal(cw, cw->entries + i);
+            if (c && s->distance[c->y][c->x] < nearest)
+            {
+                nearest = s->distance[c->y][c->x];
+                s->target = (u16)i;
+                goal = c;
+            }
+        }
+
+        if (s->target == CW_NO_ENTRY)
+            return SOAK_NEW_PUZZLE;
+
+        e = cw_entry(cw, s->target);
+    }
+
+    C bool vertical = e->dir_y != 0;
+    if (goal != selected)
+    {
+        // back from the goal to the first step
+        C u16 start = (u16)(selected->y * CW_DIM + selected->x);
+        u16 cell = (u16)(goal->y * CW_DIM + goal->x);
+        while (s->from[cell / CW_DIM][cell % CW_DIM] != start)
+        {
+            cell = s->from[cell / CW_DIM][cell % CW_DIM];
+        }
+
+        return soak_arrow(selected, (i16)(cell % CW_DIM), (i16)(cell / CW_DIM));
+    }
+
+    // facing the wrong way, so step off along the entry. Coming back turns it around
+    if (cw->vertical_mode != vertical)
+    {
+        C size_t i = (size_t)(selected->x - e->start_x + selected->y - e->start_y);
+        if (i + 1 < e->word_length)
+            return vertical ? KEY_DOWN : KEY_RIGHT;
+
+        return vertical ? KEY_UP : KEY_LEFT;
+    }
+
+    if (rng_float(&s->rng) < SOAK_WRONG_LETTERS)
+        return 'A' + (selected->correct_letter - 'A' + rng_range(&s->rng, 1, 25)) % 26;
+
+    return selected->correct_letter;
+}
+
+void soak_new_puzzle(Soak *s)
+{
+    ++s->puzzles;
+    s->target = CW_NO_ENTRY;
+}
+
+void soak_grow(Soak *s, C double seconds)
+{
+    s->current.grow_time += seconds;
+    s->current.grow_max = MAX(s->current.grow_max, seconds);
+    ++s->current.grows;
+}
+
+void soak_frame_end(Soak *s, C Crossword *cw, C float work_time)
+{
+    if (s->seconds <= 0)
+        return;
+
+    s->current.work_time += work_time;
+    ++s->current.frames;
+
+    C size_t n = da_length(s->samples);
+    C double now = GetTime() - s->start_time;
+    if (now - (n > 0 ? s->samples[n - 1].time : 0) < SOAK_SAMPLE_SECONDS)
+        return;
+
+    Soak_Sample *sample = (Soak_Sample *)da_append((void **)&s->samples);
+    *sample = s->current;
+    sample->time = now;
+    sample->resident_bytes = soak_resident_bytes();
+    sample->counted_bytes = soak_counted_bytes();
+    sample->entries = (u32)cw_num_entries(cw);
+    sample->puzzles = s->puzzles;
+    memset(&s->current, 0, sizeof(Soak_Sample));
+
+    printf("%8.0f s  resident %7.1f MB  counted %7.1f MB  work %6.3f ms  growth %6.3f ms "
+           "(max %7.3f)  entries %4u  puzzles %u\n",
+           sample->time, (double)sample->resident_bytes / (1024.0 * 1024.0),
+           (double)sample->counted_bytes / (1024.0 * 1024.0),
+           1000 * sample->work_time / MAX(sample->frames, 1),
+           sample->grows > 0 ? 1000 * sample->grow_time / sample->grows : 0,
+           1000 * sample->grow_max, sample->entries, sample->puzzles);
+    fflush(stdout);
+}
+
+bool soak_done(C Soak *s)
+{
+    return s->seconds > 0 && GetTime() - s->start_time >= s->seconds;
+}
@@ -0,0 +1,80 @@
+#ifndef _SOAK_
+#define _SOAK_
+
+#include "common.h"
+#include "crossword.h"
+#include "rng.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// A soak test, to show that the game can run for days without using more memory or getting
+// slower. A bot plays in a hidden window as fast as it can, pressing one key a frame through the
+// same keyboard handling as the player: it moves to the nearest unfinished entry with the arrow
+// keys and types its answer, now and then getting a letter wrong and going back to fix it. Every
+// finished entry grows the board, and once there's nothing left it can finish (the board only has
+// room for so much), the game moves on to a new puzzle.
+//
+// Every SOAK_SAMPLE_SECONDS a sample is printed of the resident memory, the memory the game
+// counted (see mem.h), the mean frame work time and the mean time growing the board took after an
+// entry was finished. The first puzzle is the warm up. After it, the later half of the samples is
+// compared with the earlier half, and the soak fails if any of them went up by more than its
+// tolerance.
+#define SOAK_SAMPLE_SECONDS 10.0
+#define SOAK_WRONG_LETTERS 0.05f // chance of a wrong letter
+
+// the key soak_key returns when the bot has nothing left to finish
+#define SOAK_NEW_PUZZLE -1
+
+typedef struct
+{
+    double time; // since the soak started
+    u64 resident_bytes;
+    u64 counted_bytes;
+    double work_time; // summed over the sample's frames
+    u32 frames;
+    double grow_time; // summed over the sample's growths
+    double grow_max;
+    u32 grows;
+    u32 entries;
+    u32 puzzles; // finished before this sample
+} Soak_Sample;
+
+typedef struct
+{
+    double seconds; // how long to run, 0 when not soaking
+    double start_time;
+    Rng rng;
+
+    // the bot
+    u16 target; // the entry being finished, CW_NO_ENTRY to pick the next
+    u16 distance[CW_DIM][CW_DIM];
+    u16 from[CW_DIM][CW_DIM]; // where each cell was reached from, as y * CW_DIM + x
+    u16 queue[CW_DIM * CW_DIM];
+
+    u32 puzzles;
+    Soak_Sample current;
+    Soak_Sample *samples; // dynamic array
+} Soak;
+
+// Before the first frame, with 0 `seconds` for no soak.
+extern void soak_init(Soak *s, const double seconds, const u64 seed);
+
+// After the last frame. Prints how the samples trended and returns false if any went up.
+extern bool soak_close(Soak *s);
+
+// Start of every frame, before keyboard input. The key the bot presses (0 for none) for
+// input_inject, or SOAK_NEW_PUZZLE.
+extern int soak_key(Soak *s, const Crossword *cw, const Cell *selected);
+
+// The game moved on to a new puzzle.
+extern void soak_new_puzzle(Soak *s);
+
+// How long growing the board took after an entry was finished.
+extern void soak_grow(Soak *s, const double seconds);
+
+// After EndDrawing. `work_time` is the part of the frame spent on the frame itself.
+extern void soak_frame_end(Soak *s, const Crossword *cw, const float work_time);
+
+// Whether the soak has run for as long as it was asked to.
+extern bool soak_done(const Soak *s);
+
+#endif
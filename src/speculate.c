@@ -0,0 +1,291 @@
+#include "speculate.h"
+
+#include <string.h>
+
+#include "mem.h"
+#include "profile.h"
+#include "thread.h"
+
+// see main.c
+#define C const
+
+#define SPEC_MAX_ENTRIES 4
+#define SPEC_MAX_WORDS 8
+#define SPEC_MISSING_LETTERS 2
+
+typedef struct
+{
+    bool valid;
+    u16 entry;
+    u32 base_version;
+    u32 count;
+    u32 words[SPEC_MAX_WORDS];
+    u16 placements[SPEC_MAX_WORDS];
+} Spec_Result;
+
+struct Speculator
+{
+    Snapshot_Publisher *publisher;
+    C Dictionary *dict;
+    Mutex *lock;
+    Thread *thread;
+    bool busy;
+
+    // the job, written by the main thread before the worker starts
+    u16 job_entries[SPEC_MAX_ENTRIES];
+    size_t job_count;
+    Gen_Focus view;
+    size_t start, end;
+    u32 growth;
+
+    // only touched by the worker
+    Crossword *base;
+    Crossword *work;
+    u32 *matches; // for gen_extend_near
+
+    // shared, behind `lock`
+    Spec_Result results[SPEC_MAX_ENTRIES];
+    size_t next_result;
+};
+
+// number of letters the player still has to get right, 0 for finished entries
+static size_t spec_missing_letters(C Crossword *cw, C Crossword_Entry *e)
+{
+    if (e->complete)
+        return 0;
+
+    size_t missing = 0;
+    for (size_t i = 0; i < e->word_length; ++i)
+    {
+        C Cell *c = &cw->cells[e->start_y + e->dir_y * (i16)i][e->start_x + e->dir_x * (i16)i];
+        missing += c->user_letter != c->correct_letter;
+    }
+
+    return missing;
+}
+
+static Spec_Result *spec_find(Speculator *s, C u16 entry, C u32 base_version)
+{
+    for (size_t i = 0; i < SPEC_MAX_ENTRIES; ++i)
+    {
+        Spec_Result *r = s->results + i;
+        if (r->valid && r->entry == entry && r->base_version == base_version)
+            return r;
+    }
+
+    return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+static void spec_worker(void *arg)
+{
+    Speculator *s = (Speculator *)arg;
+    profile_thread("speculate");
+    PROFILE_BEGIN("speculate");
+
+    Board_Snapshot *snapshot = snapshot_acquire(s->publisher);
+    if (snapshot)
+    {
+        snapshot_restore(snapshot, s->base);
+        snapshot_release(s->publisher, snapshot);
+    }
+
+    for (size_t j = 0; snapshot && j < s->job_count; ++j)
+    {
+        C u16 entry = s->job_entries[j];
+        if (entry >= cw_num_entries(s->base))
+            continue;
+
+        // each entry gets its own stream so results don't depend on what else was speculated
+        cw_copy(s->work, s->base);
+        rng_seed(&s->work->rng, s->base->rng.state ^ ((u64)(entry + 1) * 0x9E3779B97F4A7C15ull));
+
+        // the cursor ends up on the entry's last cell, so grow around that
+        C Crossword_Entry *e = s->work->entries + entry;
+        Gen_Focus focus = s->view;
+        focus.x = (i16)(e->start_x + e->dir_x * ((i16)e->word_length - 1));
+        focus.y = (i16)(e->start_y + e->dir_y * ((i16)e->word_length - 1));
+
+        C size_t before = cw_num_entries(s->work);
+        PROFILE_SCOPE("grow entry")
+        {
+            for (u32 g = 0; g < s->growth; ++g)
+            {
+                gen_extend_near(s->work, s->dict, s->start, s->end, DICT_ANY_CATEGORY,
+                                &focus, &s->matches);
+            }
+        }
+
+        Spec_Result r = {0};
+        r.valid = true;
+        r.entry = entry;
+        r.base_version = s->base->entries_version;
+        for (size_t i = before; i < cw_num_entries(s->work); ++i)
+        {
+            C Crossword_Entry *added = s->work->entries + i;
+            r.words[r.count] = added->word_index;
+            r.placements[r.count] = cw_pack_placement(added->start_x, added->start_y,
+                                                      added->dir_y == 1, added->clue_index);
+            ++r.count;
+        }
+
+        mutex_lock(s->lock);
+        size_t slot = SPEC_MAX_ENTRIES;
+        for (size_t i = 0; i < SPEC_MAX_ENTRIES && slot == SPEC_MAX_ENTRIES; ++i)
+        {
+            if (!s->results[i].valid)
+                slot = i;
+        }
+        if (slot == SPEC_MAX_ENTRIES)
+        {
+            slot = s->next_result;
+            s->next_result = (s->next_result + 1) % SPEC_MAX_ENTRIES;
+        }
+        s->results[slot] = r;
+        mutex_unlock(s->lock);
+    }
+
+    PROFILE_END();
+
+    mutex_lock(s->lock);
+    s->busy = false;
+    mutex_unlock(s->lock);
+}
+
+Speculator *spec_create(Snapshot_Publisher *publisher, C Dictionary *dict)
+{
+    Speculator *s = (Speculator *)mem_alloc(MEM_SPECULATE, sizeof(Speculator));
+    s->publisher = publisher;
+    s->dict = dict;
+    s->lock = mutex_create();
+
+    s->base = (Crossword *)mem_alloc(MEM_SPECULATE, sizeof(Crossword));
+    s->work = (Crossword *)mem_alloc(MEM_SPECULATE, sizeof(Crossword));
+    cw_init(s->base);
+    cw_init(s->work);
+    s->matches = (u32 *)da_init(sizeof(u32), 64);
+
+    // there's only ever one job at a time, so starting one never has to allocate
+    thread_reserve(1);
+    return s;
+}
+
+void spec_destroy(Speculator *s)
+{
+    if (s->thread)
+    {
+        thread_join(s->thread);
+    }
+
+    cw_cleanup(s->base);
+    cw_cleanup(s->work);
+    mem_free(s->base);
+    mem_free(s->work);
+    da_cleanup(s->matches);
+    mutex_destroy(s->lock);
+    mem_free(s);
+}
+
+void spec_update(Speculator *s, C Crossword *cw, C Gen_Focus *view, C size_t start, C size_t end,
+                 C u32 growth)
+{
+    mutex_lock(s->lock);
+    C bool busy = s->busy;
+    if (!busy)
+    {
+        for (size_t i = 0; i < SPEC_MAX_ENTRIES; ++i)
+        {
+            s->results[i].valid &= s->results[i].base_version == cw->entries_version;
+        }
+    }
+    mutex_unlock(s->lock);
+
+    if (busy)
+        return;
+
+    // the last job already finished, so this join doesn't block
+    if (s->thread)
+    {
+        thread_join(s->thread);
+        s->thread = NULL;
+    }
+
+    // entries closest to done first, since they're the ones about to be needed
+    s->job_count = 0;
+    for (size_t missing = 1; missing <= SPEC_MISSING_LETTERS; ++missing)
+    {
+        for (size_t i = 0; i < cw_num_entries(cw) && s->job_count < SPEC_MAX_ENTRIES; ++i)
+        {
+            if (spec_missing_letters(cw, cw->entries + i) != missing)
+                continue;
+
+            mutex_lock(s->lock);
+            C bool known = spec_find(s, (u16)i, cw->entries_version) != NULL;
+            mutex_unlock(s->lock);
+
+            if (!known)
+            {
+                s->job_entries[s->job_count++] = (u16)i;
+            }
+        }
+    }
+
+    if (s->job_count == 0)
+        return;
+
+    s->view = *view;
+    s->start = start;
+    s->end = end;
+    s->growth = MIN(growth, SPEC_MAX_WORDS);
+    s->busy = true;
+    s->thread = thread_create(spec_worker, s);
+}
+
+bool spec_commit(Speculator *s, Crossword *cw, C u16 entry, C u32 entries_version)
+{
+    mutex_lock(s->lock);
+    C Spec_Result *found = spec_find(s, entry, entries_version);
+    Spec_Result r = {0};
+    if (found)
+    {
+        r = *found;
+    }
+
+    // the board is about to change, so nothing else is good anymore
+    for (size_t i = 0; i < SPEC_MAX_ENTRIES; ++i)
+    {
+        s->results[i].valid = false;
+    }
+    mutex_unlock(s->lock);
+
+    if (!r.valid)
+        return false;
+
+    for (u32 i = 0; i < r.count; ++i)
+    {
+        i16 x, y;
+        bool vertical;
+        u8 clue;
+        cw_unpack_placement(r.placements[i], &x, &y, &vertical, &clue);
+
+        // worked out on the same entries, so these always fit, but never trust it blindly
+        if (cw_contains_word(cw, r.words[i]) ||
+            !cw_can_place(cw, words + r.words[i], x, y, vertical))
+        {
+            return i > 0;
+        }
+
+        cw_add_entry(cw, r.words[i], x, y, vertical, clue);
+    }
+
+    return true;
+}
+
+void spec_wait(Speculator *s)
+{
+    if (s->thread)
+    {
+        thread_join(s->thread);
+        s->thread = NULL;
+    }
+}
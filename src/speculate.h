@@ -0,0 +1,42 @@
+#ifndef _SPECULATE_
+#define _SPECULATE_
+
+#include <stddef.h>
+
+#include "common.h"
+#include "crossword.h"
+#include "dictionary.h"
+#include "generator.h"
+#include "snapshot.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Growing the board when an entry is finished (see gen_extend_near) is too slow to do in the frame
+// the entry is finished. Instead, every entry that is a letter or two away from done gets its
+// growth worked out ahead of time on a background thread, from the latest published snapshot.
+// When the entry is finished the matching result is added to the board immediately.
+//
+// Results are only good for the exact set of entries they were worked out from, so finishing one
+// entry (which grows the board) throws the others away and they are worked out again.
+typedef struct Speculator Speculator;
+
+// The dictionary and publisher must outlive the speculator.
+extern Speculator *spec_create(Snapshot_Publisher *publisher, const Dictionary *dict);
+extern void spec_destroy(Speculator *s);
+
+// Main thread, once a frame after publishing. Starts working on any nearly finished entries that
+// don't have a result yet, growing each by `growth` words from words[start, end). `view` is where
+// the player is looking; each entry is grown around its own last cell.
+extern void spec_update(Speculator *s, const Crossword *cw, const Gen_Focus *view,
+                        const size_t start, const size_t end, const u32 growth);
+
+// Main thread. Adds the precomputed growth for `entry` if there is one that was worked out from
+// the board as it was at `entries_version` (before the entry was finished). Returns false if there
+// is no such result, in which case the caller grows the board itself.
+extern bool spec_commit(Speculator *s, Crossword *cw, const u16 entry, const u32 entries_version);
+
+// Main thread. Blocks until the work started by the last spec_update is done, which makes what
+// spec_commit finds depend only on the frames played rather than on how fast the worker is. Only
+// for replays (see replay.h); the game itself never waits.
+extern void spec_wait(Speculator *s);
+
+#endif
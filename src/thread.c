@@ -0,0 +1,281 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "thread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mem.h"
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define THREAD_NONE
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+struct Thread
+{
+    Thread_Func func;
+    void *arg;
+    Thread *next_spare;
+#if defined(THREAD_NONE)
+#elif defined(_WIN32)
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+};
+
+struct Mutex
+{
+#if defined(THREAD_NONE)
+    int unused;
+#elif defined(_WIN32)
+    CRITICAL_SECTION cs;
+#else
+    pthread_mutex_t m;
+#endif
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Joined handles are kept for the next thread_create, so that a worker started
+// for every job (see speculate.c) doesn't allocate once one has finished.
+#if defined(THREAD_NONE)
+#define THREAD_SPARE_LOCK() ((void)0)
+#define THREAD_SPARE_UNLOCK() ((void)0)
+#elif defined(_WIN32)
+static SRWLOCK thread_spare_lock = SRWLOCK_INIT;
+#define THREAD_SPARE_LOCK() AcquireSRWLockExclusive(&thread_spare_lock)
+#define THREAD_SPARE_UNLOCK() ReleaseSRWLockExclusive(&thread_spare_lock)
+#else
+static pthread_mutex_t thread_spare_lock = PTHREAD_MUTEX_INITIALIZER;
+#define THREAD_SPARE_LOCK() pthread_mutex_lock(&thread_spare_lock)
+#define THREAD_SPARE_UNLOCK() pthread_mutex_unlock(&thread_spare_lock)
+#endif
+
+static Thread *thread_spares = NULL;
+
+static Thread *thread_new(Thread_Func func, void *arg)
+{
+    THREAD_SPARE_LOCK();
+    Thread *t = thread_spares;
+    if (t)
+    {
+        thread_spares = t->next_spare;
+    }
+    THREAD_SPARE_UNLOCK();
+
+    if (!t)
+    {
+        t = (Thread *)mem_alloc(MEM_THREAD, sizeof(Thread));
+    }
+
+    t->func = func;
+    t->arg = arg;
+    t->next_spare = NULL;
+    return t;
+}
+
+static void thread_recycle(Thread *t)
+{
+    THREAD_SPARE_LOCK();
+    t->next_spare = thread_spares;
+    thread_spares = t;
+    THREAD_SPARE_UNLOCK();
+}
+
+void thread_reserve(size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        thread_recycle((Thread *)mem_alloc(MEM_THREAD, sizeof(Thread)));
+    }
+}
+
+#if !defined(__GNUC__) && !defined(__clang__)
+///////////////////////////////////////////////////////////////////////////////
+// Atomics for compilers without the GNU builtins (MSVC)
+#if !defined(_WIN32)
+#error "thread.h needs GNU style atomic builtins on this platform"
+#endif
+
+u64 atomic_load_u64(const u64 *p)
+{
+    return (u64)InterlockedCompareExchange64((volatile LONG64 *)p, 0, 0);
+}
+
+void atomic_store_u64(u64 *p, const u64 value)
+{
+    InterlockedExchange64((volatile LONG64 *)p, (LONG64)value);
+}
+
+u64 atomic_add_u64(u64 *p, const u64 value)
+{
+    return (u64)InterlockedExchangeAdd64((volatile LONG64 *)p, (LONG64)value) +
+           value;
+}
+#endif
+
+#if defined(THREAD_NONE)
+///////////////////////////////////////////////////////////////////////////////
+// No threads: run the work immediately
+Thread *thread_create(Thread_Func func, void *arg)
+{
+    Thread *t = thread_new(func, arg);
+    func(arg);
+    return t;
+}
+
+void thread_join(Thread *t)
+{
+    thread_recycle(t);
+}
+
+size_t thread_hardware_count(void)
+{
+    return 1;
+}
+
+Mutex *mutex_create(void)
+{
+    return (Mutex *)mem_alloc(MEM_THREAD, sizeof(Mutex));
+}
+
+void mutex_destroy(Mutex *m)
+{
+    mem_free(m);
+}
+
+void mutex_lock(Mutex *m)
+{
+    (void)m;
+}
+
+void mutex_unlock(Mutex *m)
+{
+    (void)m;
+}
+
+#elif defined(_WIN32)
+///////////////////////////////////////////////////////////////////////////////
+// Win32
+static DWORD WINAPI thread_start(LPVOID arg)
+{
+    Thread *t = (Thread *)arg;
+    t->func(t->arg);
+    return 0;
+}
+
+Thread *thread_create(Thread_Func func, void *arg)
+{
+    Thread *t = thread_new(func, arg);
+    t->handle = CreateThread(NULL, 0, thread_start, t, 0, NULL);
+    if (t->handle == NULL)
+    {
+        fprintf(stderr, "Unable to create thread.\n");
+        exit(1);
+    }
+
+    return t;
+}
+
+void thread_join(Thread *t)
+{
+    WaitForSingleObject(t->handle, INFINITE);
+    CloseHandle(t->handle);
+    thread_recycle(t);
+}
+
+size_t thread_hardware_count(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (size_t)info.dwNumberOfProcessors : 1;
+}
+
+Mutex *mutex_create(void)
+{
+    Mutex *m = (Mutex *)mem_alloc(MEM_THREAD, sizeof(Mutex));
+    InitializeCriticalSection(&m->cs);
+    return m;
+}
+
+void mutex_destroy(Mutex *m)
+{
+    DeleteCriticalSection(&m->cs);
+    mem_free(m);
+}
+
+void mutex_lock(Mutex *m)
+{
+    EnterCriticalSection(&m->cs);
+}
+
+void mutex_unlock(Mutex *m)
+{
+    LeaveCriticalSection(&m->cs);
+}
+
+#else
+///////////////////////////////////////////////////////////////////////////////
+// pthreads
+static void *thread_start(void *arg)
+{
+    Thread *t = (Thread *)arg;
+    t->func(t->arg);
+    return NULL;
+}
+
+Thread *thread_create(Thread_Func func, void *arg)
+{
+    Thread *t = thread_new(func, arg);
+    if (pthread_create(&t->handle, NULL, thread_start, t) != 0)
+    {
+        fprintf(stderr, "Unable to create thread.\n");
+        exit(1);
+    }
+
+    return t;
+}
+
+void thread_join(Thread *t)
+{
+    pthread_join(t->handle, NULL);
+    thread_recycle(t);
+}
+
+size_t thread_hardware_count(void)
+{
+    const long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (size_t)n : 1;
+}
+
+Mutex *mutex_create(void)
+{
+    Mutex *m = (Mutex *)mem_alloc(MEM_THREAD, sizeof(Mutex));
+    pthread_mutex_init(&m->m, NULL);
+    return m;
+}
+
+void mutex_destroy(Mutex *m)
+{
+    pthread_mutex_destroy(&m->m);
+    mem_free(m);
+}
+
+void mutex_lock(Mutex *m)
+{
+    pthread_mutex_lock(&m->m);
+}
+
+void mutex_unlock(Mutex *m)
+{
+    pthread_mutex_unlock(&m->m);
+}
+#endif
@@ -0,0 +1,64 @@
+#ifndef _THREAD_
+#define _THREAD_
+
+#include <stddef.h>
+
+#include "common.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Thin wrapper over pthreads and Win32 threads. The handles are opaque so that
+// windows.h never ends up in the same translation unit as raylib.h. On the
+// web build there are no threads, so thread_create runs the function inline.
+///////////////////////////////////////////////////////////////////////////////
+typedef struct Thread Thread;
+typedef struct Mutex Mutex;
+
+typedef void (*Thread_Func)(void *arg);
+
+extern Thread *thread_create(Thread_Func func, void *arg);
+extern void thread_join(Thread *t);
+// Keeps `count` more handles ready, so that as many thread_create calls after
+// it don't allocate.
+extern void thread_reserve(size_t count);
+extern size_t thread_hardware_count(void);
+
+extern Mutex *mutex_create(void);
+extern void mutex_destroy(Mutex *m);
+extern void mutex_lock(Mutex *m);
+extern void mutex_unlock(Mutex *m);
+
+// Storage that every thread has its own copy of, for statics.
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// Relaxed atomic loads and stores, for lock-free tables shared between threads
+// where every slot is a single word. There is no ordering between slots. The
+// adds are for counters.
+///////////////////////////////////////////////////////////////////////////////
+#if defined(__GNUC__) || defined(__clang__)
+static inline u64 atomic_load_u64(const u64 *p)
+{
+    return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+
+static inline void atomic_store_u64(u64 *p, const u64 value)
+{
+    __atomic_store_n(p, value, __ATOMIC_RELAXED);
+}
+
+// returns the new value
+static inline u64 atomic_add_u64(u64 *p, const u64 value)
+{
+    return __atomic_add_fetch(p, value, __ATOMIC_RELAXED);
+}
+#else
+extern u64 atomic_load_u64(const u64 *p);
+extern void atomic_store_u64(u64 *p, const u64 value);
+extern u64 atomic_add_u64(u64 *p, const u64 value);
+#endif
+
+#endif
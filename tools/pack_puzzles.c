@@ -0,0 +1,259 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Batch generates puzzles for every difficulty band and writes them to a puzzle pack that the game
+// maps at startup (see src/puzzle_pack.h). Generation is split across threads, but every puzzle is
+// seeded from its own index so the output is the same no matter how many threads are used.
+//
+// Each puzzle starts from a filled lattice of interlocking words (see gen_lattice_puzzle) and falls
+// back to greedy placement when the fill runs out of nodes. The dead ends the fill proves are
+// shared between threads, which only changes how fast a fill finishes, so the output stays the
+// same unless a fill is right at the node limit.
+//
+// `-c` themes the pack: every word comes from that category of clues.h, and puzzles whose lattice
+// can't be filled from it are dropped instead of falling back.
+//
+//   zig build pack -- -o puzzles.pack -b 8 -n 512 -e 12 -l 3
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+#include "crossword.h"
+#include "dictionary.h"
+#include "fill.h"
+#include "generator.h"
+#include "puzzle_pack.h"
+#include "thread.h"
+
+#define C const
+
+#define MAX_THREADS 64
+#define MAX_LATTICE_SIZE 8
+#define FILL_NODE_LIMIT 20000
+#define FILL_TABLE_LOG2_SIZE 20
+
+typedef struct
+{
+    size_t band_count;
+    size_t puzzles_per_band;
+    size_t entries_per_puzzle;
+    size_t lattice_size;
+    u8 category;
+    u64 seed;
+
+    Dictionary *dict;
+    Fill_Table *table;
+
+    // job i writes its entries to [i * entries_per_puzzle, ...) and its count to entry_counts[i]
+    u32 *entry_word;
+    u16 *entry_placement;
+    u32 *entry_counts;
+
+    Mutex *lock;
+    size_t next_job;
+} Pack_Job_Queue;
+
+static void *pack_alloc(C size_t bytes)
+{
+    void *ptr = calloc(1, bytes);
+    if (!ptr)
+    {
+        fprintf(stderr, "Unable to allocate %zu bytes.\n", bytes);
+        exit(1);
+    }
+
+    return ptr;
+}
+
+static void pack_worker(void *arg)
+{
+    Pack_Job_Queue *q = (Pack_Job_Queue *)arg;
+    C size_t total_jobs = q->band_count * q->puzzles_per_band;
+    Crossword *cw = (Crossword *)pack_alloc(sizeof(Crossword));
+    cw_init(cw);
+
+    for (;;)
+    {
+        mutex_lock(q->lock);
+        C size_t job = q->next_job++;
+        mutex_unlock(q->lock);
+
+        if (job >= total_jobs)
+            break;
+
+        size_t start, end;
+        gen_band_range(job / q->puzzles_per_band, q->band_count, &start, &end);
+        rng_seed(&cw->rng, q->seed ^ ((u64)(job + 1) * 0x9E3779B97F4A7C15ull));
+        if (q->lattice_size == 0 ||
+            gen_lattice_puzzle(cw, q->dict, q->table, start, end, q->category, q->lattice_size,
+                               q->entries_per_puzzle, FILL_NODE_LIMIT) == 0)
+        {
+            if (q->category == DICT_ANY_CATEGORY)
+                gen_puzzle(cw, start, end, q->entries_per_puzzle);
+            else
+                cw_clear(cw);
+        }
+
+        // main makes sure the lattice fits, but a job must never write into the next one's slots
+        C size_t base = job * q->entries_per_puzzle;
+        C size_t count = MIN(cw_num_entries(cw), q->entries_per_puzzle);
+        for (size_t i = 0; i < count; ++i)
+        {
+            C Crossword_Entry *e = cw->entries + i;
+            q->entry_word[base + i] = e->word_index;
+            q->entry_placement[base + i] =
+                cw_pack_placement(e->start_x, e->start_y, e->dir_y == 1, e->clue_index);
+        }
+
+        q->entry_counts[job] = (u32)count;
+    }
+
+    cw_cleanup(cw);
+    free(cw);
+}
+
+static void usage(C char *name)
+{
+    fprintf(stderr,
+            "usage: %s [-o out.pack] [-b bands] [-n puzzles per band] [-e entries per puzzle] "
+            "[-l lattice size] [-c category] [-t threads] [-s seed]\n"
+            "a lattice of size l has 2 * l words, so -e has to be at least that\n",
+            name);
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    C char *out_path = "puzzles.pack";
+    C char *category = NULL;
+    size_t thread_count = thread_hardware_count();
+
+    Pack_Job_Queue q = {0};
+    q.band_count = 8;
+    q.puzzles_per_band = 512;
+    q.entries_per_puzzle = 12;
+    q.lattice_size = 3;
+    q.seed = 0xC0FFEE;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (i + 1 >= argc)
+            usage(argv[0]);
+
+        C char *flag = argv[i];
+        C char *value = argv[++i];
+        if (strcmp(flag, "-o") == 0)
+            out_path = value;
+        else if (strcmp(flag, "-b") == 0)
+            q.band_count = strtoul(value, NULL, 10);
+        else if (strcmp(flag, "-n") == 0)
+            q.puzzles_per_band = strtoul(value, NULL, 10);
+        else if (strcmp(flag, "-e") == 0)
+            q.entries_per_puzzle = strtoul(value, NULL, 10);
+        else if (strcmp(flag, "-l") == 0)
+            q.lattice_size = strtoul(value, NULL, 10);
+        else if (strcmp(flag, "-c") == 0)
+            category = value;
+        else if (strcmp(flag, "-t") == 0)
+            thread_count = strtoul(value, NULL, 10);
+        else if (strcmp(flag, "-s") == 0)
+            q.seed = strtoull(value, NULL, 10);
+        else
+            usage(argv[0]);
+    }
+
+    if (q.band_count == 0 || q.band_count > words_count || q.puzzles_per_band == 0 ||
+        q.entries_per_puzzle == 0 || q.entries_per_puzzle > CW_MAX_ENTRIES ||
+        q.lattice_size > MAX_LATTICE_SIZE || q.entries_per_puzzle < 2 * q.lattice_size)
+    {
+        usage(argv[0]);
+    }
+
+    // only the lattice fill and the growth after it can be themed
+    if (category)
+    {
+        if (q.lattice_size == 0)
+            usage(argv[0]);
+
+        q.category = dict_category(category);
+        if (q.category == DICT_ANY_CATEGORY)
+        {
+            fprintf(stderr, "There's no category called \"%s\" in clues.h.\n", category);
+            exit(1);
+        }
+    }
+
+    thread_count = MAX(1, MIN(thread_count, MAX_THREADS));
+
+    C size_t total_jobs = q.band_count * q.puzzles_per_band;
+    q.entry_word = (u32 *)pack_alloc(sizeof(u32) * total_jobs * q.entries_per_puzzle);
+    q.entry_placement = (u16 *)pack_alloc(sizeof(u16) * total_jobs * q.entries_per_puzzle);
+    q.entry_counts = (u32 *)pack_alloc(sizeof(u32) * total_jobs);
+    q.lock = mutex_create();
+
+    Dictionary dict;
+    dict_init(&dict);
+    q.dict = &dict;
+    q.table = fill_table_create(FILL_TABLE_LOG2_SIZE);
+
+    printf("Generating %zu puzzles (%zu bands) on %zu threads...\n", total_jobs, q.band_count,
+           thread_count);
+
+    Thread *threads[MAX_THREADS];
+    for (size_t i = 0; i < thread_count; ++i)
+        threads[i] = thread_create(pack_worker, &q);
+    for (size_t i = 0; i < thread_count; ++i)
+        thread_join(threads[i]);
+
+    // compact the fixed size job slots into the packed layout, dropping puzzles that came out
+    // too small to be worth playing
+    u32 *band_first_puzzle = (u32 *)pack_alloc(sizeof(u32) * (q.band_count + 1));
+    u32 *puzzle_first_entry = (u32 *)pack_alloc(sizeof(u32) * (total_jobs + 1));
+    u32 puzzle_count = 0;
+    u32 entry_count = 0;
+
+    for (size_t band = 0; band < q.band_count; ++band)
+    {
+        band_first_puzzle[band] = puzzle_count;
+        for (size_t p = 0; p < q.puzzles_per_band; ++p)
+        {
+            C size_t job = band * q.puzzles_per_band + p;
+            if (q.entry_counts[job] < 2)
+                continue;
+
+            puzzle_first_entry[puzzle_count++] = entry_count;
+            C size_t base = job * q.entries_per_puzzle;
+            for (size_t i = 0; i < q.entry_counts[job]; ++i)
+            {
+                q.entry_word[entry_count] = q.entry_word[base + i];
+                q.entry_placement[entry_count] = q.entry_placement[base + i];
+                ++entry_count;
+            }
+        }
+    }
+
+    band_first_puzzle[q.band_count] = puzzle_count;
+    puzzle_first_entry[puzzle_count] = entry_count;
+
+    C bool ok = pack_write(out_path, (u32)q.band_count, band_first_puzzle, puzzle_count,
+                           puzzle_first_entry, entry_count, q.entry_word, q.entry_placement);
+    if (ok)
+    {
+        printf("Wrote %u puzzles (%u entries) to %s\n", puzzle_count, entry_count, out_path);
+    }
+    else
+    {
+        fprintf(stderr, "Unable to write %s\n", out_path);
+    }
+
+    mutex_destroy(q.lock);
+    fill_table_destroy(q.table);
+    dict_cleanup(&dict);
+    free(band_first_puzzle);
+    free(puzzle_first_entry);
+    free(q.entry_word);
+    free(q.entry_placement);
+    free(q.entry_counts);
+
+    return ok ? 0 : 1;
+}